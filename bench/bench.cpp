@@ -0,0 +1,12 @@
+#include <benchmark/benchmark.h>
+
+#include "pathfinder.cpp"
+#include "weight_filters.cpp"
+#include "number_parsing.cpp"
+#include "smart_pointers.cpp"
+#include "collections.cpp"
+#include "parallel_collections.cpp"
+#include "string_column.cpp"
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,144 @@
+#include <benchmark/benchmark.h>
+
+#include "small_vector.h"
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+// The algorithms exercised in tests/collections.cpp, on inputs large enough
+// for memory bandwidth and vectorization to show.
+const std::vector<int>& randomInts(std::size_t count) {
+    static std::vector<int> numbers{};
+
+    if (numbers.size() != count) {
+        std::mt19937 random{31};
+        numbers.resize(count);
+
+        for (auto& number : numbers) {
+            number = static_cast<int>(random() % 1000);
+        }
+    }
+
+    return numbers;
+}
+
+
+static void BM_Transform(benchmark::State& state) {
+    auto numbers = randomInts(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        std::transform(numbers.begin(), numbers.end(), numbers.begin(), [](int x) { return x + 1; });
+        benchmark::DoNotOptimize(numbers.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * numbers.size()));
+}
+
+
+static void BM_Reduce(benchmark::State& state) {
+    const auto& numbers = randomInts(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::reduce(numbers.begin(), numbers.end(), 0L));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * numbers.size()));
+}
+
+
+static void BM_Accumulate(benchmark::State& state) {
+    const auto& numbers = randomInts(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(numbers.begin(), numbers.end(), 0L));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * numbers.size()));
+}
+
+
+// Keeps about half of the input; argument 1 reserves the output up front.
+static void BM_CopyIfBackInserter(benchmark::State& state) {
+    const auto& numbers = randomInts(static_cast<std::size_t>(state.range(0)));
+    bool reserve = state.range(1) != 0;
+
+    for (auto _ : state) {
+        std::vector<int> kept{};
+        if (reserve) {
+            kept.reserve(numbers.size());
+        }
+
+        std::copy_if(numbers.begin(), numbers.end(), std::back_inserter(kept), [](int x) { return x % 2 == 0; });
+        benchmark::DoNotOptimize(kept.data());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * numbers.size()));
+}
+
+
+static void BM_CopyFrontInserter(benchmark::State& state) {
+    const auto& numbers = randomInts(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        std::list<int> copied{};
+        std::copy(numbers.begin(), numbers.end(), std::front_inserter(copied));
+        benchmark::DoNotOptimize(copied.front());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * numbers.size()));
+}
+
+
+BENCHMARK(BM_Transform)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_Reduce)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_Accumulate)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_CopyIfBackInserter)->ArgNames({"size", "reserve"})->ArgsProduct({{1 << 10, 1 << 20}, {0, 1}});
+BENCHMARK(BM_CopyFrontInserter)->Arg(1 << 10)->Arg(1 << 20);
+
+
+// Many short lists built and dropped, like per-query paths: lengths 1 to 8.
+template <typename List>
+void shortLists(benchmark::State& state) {
+    const auto& numbers = randomInts(1 << 16);
+
+    for (auto _ : state) {
+        std::size_t total = 0;
+
+        for (std::size_t i = 0; i < numbers.size(); i++) {
+            List list{};
+            auto length = static_cast<std::size_t>(numbers[i]) % 8 + 1;
+
+            for (std::size_t j = 0; j < length; j++) {
+                list.push_back(numbers[(i + j) % numbers.size()]);
+            }
+
+            total += static_cast<std::size_t>(std::accumulate(list.begin(), list.end(), 0));
+        }
+
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * numbers.size()));
+}
+
+static void BM_ShortListsStdVector(benchmark::State& state) {
+    shortLists<std::vector<int>>(state);
+}
+
+static void BM_ShortListsSmallVector(benchmark::State& state) {
+    shortLists<SmallVector<int, 8>>(state);
+}
+
+static void BM_ShortListsStaticVector(benchmark::State& state) {
+    shortLists<StaticVector<int, 8>>(state);
+}
+
+BENCHMARK(BM_ShortListsStdVector);
+BENCHMARK(BM_ShortListsSmallVector);
+BENCHMARK(BM_ShortListsStaticVector);
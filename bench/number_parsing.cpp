@@ -0,0 +1,194 @@
+#include <benchmark/benchmark.h>
+
+#include "number_parsing.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+// One line of random integers, about the given number of megabytes long.
+// With a width the numbers are right-aligned in columns of that many
+// characters, otherwise they are separated by single spaces.
+const std::string& numberLine(std::size_t megabytes, std::size_t width = 0) {
+    static std::string line{};
+    static std::pair<std::size_t, std::size_t> generated{};
+
+    if (generated != std::pair{megabytes, width}) {
+        std::mt19937 random{109};
+        line.clear();
+        line.reserve(megabytes << 20);
+
+        while (line.size() < (megabytes << 20)) {
+            auto number = std::to_string(static_cast<int>(random()) >> (random() % 31));
+            line.append(width > number.size() ? width - number.size() : 1, ' ');
+            line += number;
+        }
+        line += '\n';
+
+        generated = {megabytes, width};
+    }
+
+    return line;
+}
+
+
+// The getline + istringstream + istream_iterator reader this replaces.
+static void BM_ReadNumbersIstream(benchmark::State& state) {
+    const auto& line = numberLine(static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(1)));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::istringstream input(line);
+        state.ResumeTiming();
+
+        std::string text;
+        std::getline(input, text);
+
+        std::istringstream lineStream(text);
+        std::vector<int> numbers(std::istream_iterator<int>(lineStream), std::istream_iterator<int>{});
+        benchmark::DoNotOptimize(numbers.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+
+
+static void BM_ReadNumbers(benchmark::State& state) {
+    const auto& line = numberLine(static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(1)));
+    std::vector<int> numbers{};
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::istringstream input(line);
+        state.ResumeTiming();
+
+        readNumbers(input, numbers);
+        benchmark::DoNotOptimize(numbers.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+
+
+static void BM_ParseNumbers(benchmark::State& state) {
+    const auto& line = numberLine(static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(2)));
+    auto level = static_cast<SimdLevel>(state.range(1));
+    std::vector<int> numbers{};
+
+    if (level > detectedSimdLevel()) {
+        state.SkipWithError("SIMD level not supported by this CPU");
+        return;
+    }
+
+    for (auto _ : state) {
+        numbers.clear();
+        parseNumbers(std::string_view(line), numbers, level);
+        benchmark::DoNotOptimize(numbers.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+
+
+BENCHMARK(BM_ReadNumbersIstream)->ArgNames({"MB", "width"})->ArgsProduct({{64}, {0, 16}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReadNumbers)->ArgNames({"MB", "width"})->ArgsProduct({{64}, {0, 16}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseNumbers)
+    ->ArgNames({"MB", "level", "width"})
+    ->ArgsProduct({
+        {64},
+        {static_cast<int>(SimdLevel::Scalar), static_cast<int>(SimdLevel::Sse41), static_cast<int>(SimdLevel::Avx2)},
+        {0, 16}
+    })
+    ->Unit(benchmark::kMillisecond);
+
+
+// The same line written to a file, for sizes that do not fit in memory
+// next to the copies the istream reader makes.
+const std::string& numberFile(std::size_t megabytes) {
+    static std::string path{};
+    static std::size_t generated = 0;
+
+    if (generated != megabytes) {
+        path = (std::filesystem::temp_directory_path() / "bench_numbers.txt").string();
+        std::ofstream output(path, std::ios::binary);
+        std::mt19937 random{109};
+        std::string piece{};
+
+        for (std::size_t written = 0; written < (megabytes << 20); written += piece.size()) {
+            piece.clear();
+            while (piece.size() < (1 << 20)) {
+                piece += ' ';
+                piece += std::to_string(static_cast<int>(random()) >> (random() % 31));
+            }
+            output << piece;
+        }
+        output << '\n';
+
+        generated = megabytes;
+    }
+
+    return path;
+}
+
+
+static void BM_ReadNumberFileIstream(benchmark::State& state) {
+    const auto& path = numberFile(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        std::ifstream input(path, std::ios::binary);
+
+        std::string text;
+        std::getline(input, text);
+
+        std::istringstream lineStream(text);
+        std::vector<int> numbers(std::istream_iterator<int>(lineStream), std::istream_iterator<int>{});
+        benchmark::DoNotOptimize(numbers.data());
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * std::filesystem::file_size(path)));
+}
+
+static void BM_ReadNumberFile(benchmark::State& state) {
+    const auto& path = numberFile(static_cast<std::size_t>(state.range(0)));
+    std::vector<int> numbers{};
+    std::string buffer{};
+
+    for (auto _ : state) {
+        std::ifstream input(path, std::ios::binary);
+
+        readNumbers(input, numbers, buffer);
+        benchmark::DoNotOptimize(numbers.data());
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * std::filesystem::file_size(path)));
+}
+
+BENCHMARK(BM_ReadNumberFileIstream)->ArgName("MB")->Arg(1024)->Iterations(2)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReadNumberFile)->ArgName("MB")->Arg(1024)->Iterations(4)->Unit(benchmark::kMillisecond);
+
+
+static void BM_ParseNumbersInParallel(benchmark::State& state) {
+    const auto& line = numberLine(static_cast<std::size_t>(state.range(0)));
+    ThreadPool pool{static_cast<std::size_t>(state.range(1))};
+    std::vector<int> numbers{};
+
+    for (auto _ : state) {
+        numbers.clear();
+        parseNumbersInParallel(std::string_view(line), numbers, pool);
+        benchmark::DoNotOptimize(numbers.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * line.size());
+}
+
+
+BENCHMARK(BM_ParseNumbersInParallel)
+    ->ArgNames({"MB", "threads"})
+    ->ArgsProduct({{64}, {1, 2, 4, 8, 16}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
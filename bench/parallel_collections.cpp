@@ -0,0 +1,293 @@
+#include <benchmark/benchmark.h>
+
+#include "parallel_collections.h"
+#include "pipeline.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#ifdef BENCH_PARALLEL_STL
+#include <execution>
+#include <tbb/global_control.h>
+#endif
+
+
+// Stands in for the 100M-element batch inputs at a size that fits next to
+// the other benchmarks: 16M ints, 64 MB.
+const std::vector<std::int32_t>& batchInts() {
+    static std::vector<std::int32_t> values = [] {
+        std::mt19937 random{41};
+        std::vector<std::int32_t> values(std::size_t{1} << 24);
+
+        for (auto& value : values) {
+            value = static_cast<std::int32_t>(random() % 1000);
+        }
+
+        return values;
+    }();
+
+    return values;
+}
+
+const std::vector<float>& batchFloats() {
+    static std::vector<float> values(batchInts().begin(), batchInts().end());
+    return values;
+}
+
+
+ThreadPool& benchmarkPool(std::size_t threadCount) {
+    static std::map<std::size_t, std::unique_ptr<ThreadPool>> pools{};
+
+    auto& pool = pools[threadCount];
+    if (!pool) {
+        pool = std::make_unique<ThreadPool>(threadCount);
+    }
+
+    return *pool;
+}
+
+
+auto benchmarkLevel(const benchmark::State& state) {
+    return static_cast<SimdLevel>(state.range(1));
+}
+
+
+static void BM_StdTransformAddOne(benchmark::State& state) {
+    auto values = batchInts();
+
+    for (auto _ : state) {
+        std::transform(values.begin(), values.end(), values.begin(), [](std::int32_t x) { return x + 1; });
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_AddOneInParallel(benchmark::State& state) {
+    auto values = batchInts();
+    auto& pool = benchmarkPool(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        addOneInParallel(std::span<std::int32_t>(values), pool, benchmarkLevel(state));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_AddOneFloatsInParallel(benchmark::State& state) {
+    auto values = batchFloats();
+    auto& pool = benchmarkPool(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        addOneInParallel(std::span<float>(values), pool, benchmarkLevel(state));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+
+static void BM_StdReduceSum(benchmark::State& state) {
+    const auto& values = batchInts();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::reduce(values.begin(), values.end(), std::int64_t{0}));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_SumInParallel(benchmark::State& state) {
+    std::span<const std::int32_t> values{batchInts()};
+    auto& pool = benchmarkPool(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sumInParallel(values, pool, benchmarkLevel(state)));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_SumFloatsInParallel(benchmark::State& state) {
+    std::span<const float> values{batchFloats()};
+    auto& pool = benchmarkPool(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sumInParallel(values, pool, benchmarkLevel(state)));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+
+static void BM_StdCopyIfOdd(benchmark::State& state) {
+    const auto& values = batchInts();
+
+    for (auto _ : state) {
+        std::vector<std::int32_t> odd{};
+        std::copy_if(values.begin(), values.end(), std::back_inserter(odd), [](std::int32_t x) { return x % 2 != 0; });
+        benchmark::DoNotOptimize(odd.data());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_CopyIfInParallel(benchmark::State& state) {
+    std::span<const std::int32_t> values{batchInts()};
+    auto& pool = benchmarkPool(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        auto odd = copyIfInParallel(values, [](std::int32_t x) { return x % 2 != 0; }, pool);
+        benchmark::DoNotOptimize(odd.data());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_CopyOddInParallel(benchmark::State& state) {
+    std::span<const std::int32_t> values{batchInts()};
+    auto& pool = benchmarkPool(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        auto odd = copyOddInParallel(values, pool, benchmarkLevel(state));
+        benchmark::DoNotOptimize(odd.data());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+
+const std::vector<std::int64_t> BENCHMARK_THREADS{1, 2, 4, 8};
+const std::vector<std::int64_t> BENCHMARK_LEVELS{static_cast<int>(SimdLevel::Scalar), static_cast<int>(SimdLevel::Avx2)};
+
+BENCHMARK(BM_StdTransformAddOne)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AddOneInParallel)->ArgNames({"threads", "level"})->ArgsProduct({BENCHMARK_THREADS, BENCHMARK_LEVELS})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AddOneFloatsInParallel)->ArgNames({"threads", "level"})->ArgsProduct({{1}, BENCHMARK_LEVELS})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdReduceSum)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SumInParallel)->ArgNames({"threads", "level"})->ArgsProduct({BENCHMARK_THREADS, BENCHMARK_LEVELS})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SumFloatsInParallel)->ArgNames({"threads", "level"})->ArgsProduct({{1}, BENCHMARK_LEVELS})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StdCopyIfOdd)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CopyIfInParallel)->ArgName("threads")->ArgsProduct({BENCHMARK_THREADS})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CopyOddInParallel)->ArgNames({"threads", "level"})->ArgsProduct({BENCHMARK_THREADS, BENCHMARK_LEVELS})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+
+
+// Sum of the odd values after x * 3 + 1, written four ways: a vector per
+// stage, a std::views chain, and the fused pipeline, serial and parallel.
+auto timesThreePlusOne = [](std::int32_t x) { return std::int64_t{x} * 3 + 1; };
+auto isOdd = [](std::int64_t x) { return x % 2 != 0; };
+
+static void BM_MapFilterReduceIntermediateVectors(benchmark::State& state) {
+    const auto& values = batchInts();
+
+    for (auto _ : state) {
+        std::vector<std::int64_t> mapped(values.size());
+        std::transform(values.begin(), values.end(), mapped.begin(), timesThreePlusOne);
+
+        std::vector<std::int64_t> kept{};
+        std::copy_if(mapped.begin(), mapped.end(), std::back_inserter(kept), isOdd);
+
+        benchmark::DoNotOptimize(std::accumulate(kept.begin(), kept.end(), std::int64_t{0}));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_MapFilterReduceViews(benchmark::State& state) {
+    const auto& values = batchInts();
+
+    for (auto _ : state) {
+        auto kept = values | std::views::transform(timesThreePlusOne) | std::views::filter(isOdd);
+        benchmark::DoNotOptimize(std::accumulate(kept.begin(), kept.end(), std::int64_t{0}));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_MapFilterReducePipeline(benchmark::State& state) {
+    const auto& values = batchInts();
+
+    for (auto _ : state) {
+        auto total = pipeline::pipe(values)
+            | pipeline::map(timesThreePlusOne)
+            | pipeline::filter(isOdd)
+            | pipeline::reduce(std::plus<>{}, std::int64_t{0});
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_MapFilterReducePipelineInParallel(benchmark::State& state) {
+    const auto& values = batchInts();
+    auto& pool = benchmarkPool(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        auto total = pipeline::pipe(values)
+            | pipeline::map(timesThreePlusOne)
+            | pipeline::filter(isOdd)
+            | pipeline::parallelReduce(std::plus<>{}, std::int64_t{0}, pool);
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+BENCHMARK(BM_MapFilterReduceIntermediateVectors)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapFilterReduceViews)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapFilterReducePipeline)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapFilterReducePipelineInParallel)->ArgName("threads")->ArgsProduct({BENCHMARK_THREADS})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+#ifdef BENCH_PARALLEL_STL
+
+// The same pipelines through std::execution::par_unseq, which libstdc++
+// runs on TBB, capped at the given number of threads.
+static void BM_ParUnseqTransformAddOne(benchmark::State& state) {
+    tbb::global_control threads{tbb::global_control::max_allowed_parallelism, static_cast<std::size_t>(state.range(0))};
+    auto values = batchInts();
+
+    for (auto _ : state) {
+        std::transform(std::execution::par_unseq, values.begin(), values.end(), values.begin(), [](std::int32_t x) { return x + 1; });
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_ParUnseqReduceSum(benchmark::State& state) {
+    tbb::global_control threads{tbb::global_control::max_allowed_parallelism, static_cast<std::size_t>(state.range(0))};
+    const auto& values = batchInts();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::reduce(std::execution::par_unseq, values.begin(), values.end(), std::int64_t{0}));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+static void BM_ParUnseqCopyIfOdd(benchmark::State& state) {
+    tbb::global_control threads{tbb::global_control::max_allowed_parallelism, static_cast<std::size_t>(state.range(0))};
+    const auto& values = batchInts();
+
+    for (auto _ : state) {
+        std::vector<std::int32_t> odd(values.size());
+        auto end = std::copy_if(std::execution::par_unseq, values.begin(), values.end(), odd.begin(), [](std::int32_t x) { return x % 2 != 0; });
+        odd.erase(end, odd.end());
+        benchmark::DoNotOptimize(odd.data());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values.size()));
+}
+
+BENCHMARK(BM_ParUnseqTransformAddOne)->ArgName("threads")->ArgsProduct({BENCHMARK_THREADS})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParUnseqReduceSum)->ArgName("threads")->ArgsProduct({BENCHMARK_THREADS})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParUnseqCopyIfOdd)->ArgName("threads")->ArgsProduct({BENCHMARK_THREADS})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+#endif
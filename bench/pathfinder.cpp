@@ -0,0 +1,283 @@
+#include <benchmark/benchmark.h>
+
+#include "pathfinder.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+
+
+struct RandomWeightedGraph {
+    int vertexCount;
+    std::vector<std::tuple<int, int, int>> edges;
+};
+
+
+const RandomWeightedGraph& randomWeightedGraph(std::size_t edgeCount) {
+    static std::map<std::size_t, std::unique_ptr<RandomWeightedGraph>> cache{};
+
+    auto& graph = cache[edgeCount];
+    if (!graph) {
+        std::mt19937 random{7};
+        int vertexCount = static_cast<int>(std::max<std::size_t>(edgeCount / 10, 2));
+
+        graph = std::make_unique<RandomWeightedGraph>(RandomWeightedGraph{vertexCount, {}});
+        graph->edges.reserve(edgeCount);
+
+        for (std::size_t i = 0; i < edgeCount; i++) {
+            graph->edges.push_back({
+                static_cast<int>(random() % vertexCount),
+                static_cast<int>(random() % vertexCount),
+                static_cast<int>(random() % 100 + 1)
+            });
+        }
+    }
+
+    return *graph;
+}
+
+
+PathFinder<int, int>& randomPathFinder(std::size_t edgeCount) {
+    static std::map<std::size_t, std::unique_ptr<PathFinder<int, int>>> cache{};
+
+    auto& pathfinder = cache[edgeCount];
+    if (!pathfinder) {
+        pathfinder = std::make_unique<PathFinder<int, int>>();
+
+        for (auto& [from, to, weight] : randomWeightedGraph(edgeCount).edges) {
+            pathfinder->add(from, to, weight);
+        }
+
+        // Nothing leads to -1, so searching for it scans every reachable edge.
+        pathfinder->add(-1, 0, 1);
+
+        pathfinder->find(0, 1, [](int) { return true; });
+    }
+
+    return *pathfinder;
+}
+
+
+// The pre-Dijkstra find: copy every edge passing the filter, ignore endpoints.
+static void BM_PathFinderLinearScan(benchmark::State& state) {
+    const auto& edges = randomWeightedGraph(state.range(0)).edges;
+    std::function<bool(int)> filter = [](int x) { return x > 15; };
+
+    for (auto _ : state) {
+        std::vector<std::tuple<int, int, int>> prefiltered{};
+
+        std::copy_if(
+            edges.begin(),
+            edges.end(),
+            std::back_inserter(prefiltered),
+            [filter](std::tuple<int, int, int> input) {
+                return filter(std::get<2>(input));
+            }
+        );
+
+        benchmark::DoNotOptimize(prefiltered.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+
+static void BM_PathFinderFind(benchmark::State& state) {
+    auto& pathfinder = randomPathFinder(state.range(0));
+    int vertexCount = randomWeightedGraph(state.range(0)).vertexCount;
+    std::function<bool(int)> filter = [](int x) { return x > 15; };
+    std::mt19937 random{11};
+    SearchWorkspace<int> workspace{};
+
+    for (auto _ : state) {
+        int source = static_cast<int>(random() % vertexCount);
+        int target = static_cast<int>(random() % vertexCount);
+
+        auto path = pathfinder.find(source, target, filter, workspace);
+        benchmark::DoNotOptimize(path.data());
+    }
+}
+
+
+template <typename Filter>
+void findUnreachable(benchmark::State& state, const Filter& filter) {
+    auto& pathfinder = randomPathFinder(state.range(0));
+
+    for (auto _ : state) {
+        auto path = pathfinder.find(0, -1, filter);
+        benchmark::DoNotOptimize(path.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+
+static void BM_PathFinderFindStdFunction(benchmark::State& state) {
+    std::function<bool(int)> filter = [](int x) { return x > 15; };
+    findUnreachable(state, filter);
+}
+
+
+static void BM_PathFinderFindTemplatePredicate(benchmark::State& state) {
+    findUnreachable(state, [](int x) { return x > 15; });
+}
+
+
+static void BM_PathFinderFindWeightAbove(benchmark::State& state) {
+    findUnreachable(state, WeightAbove<int>{15});
+}
+
+
+BENCHMARK(BM_PathFinderLinearScan)->Arg(1 << 16)->Arg(1 << 20)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathFinderFind)->Arg(1 << 16)->Arg(1 << 20)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathFinderFindStdFunction)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathFinderFindTemplatePredicate)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathFinderFindWeightAbove)->Arg(1 << 16)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+
+const std::vector<std::pair<int, int>>& randomUnweightedEdges() {
+    static std::vector<std::pair<int, int>> edges = [] {
+        std::mt19937 random{23};
+        std::vector<std::pair<int, int>> generated(8'000'000);
+
+        for (auto& edge : generated) {
+            edge = {static_cast<int>(random() % (1 << 20)), static_cast<int>(random() % (1 << 20))};
+        }
+
+        return generated;
+    }();
+
+    return edges;
+}
+
+
+BreadthFirstSearch<int>& randomBreadthFirstSearch(std::size_t threadCount) {
+    static std::map<std::size_t, std::unique_ptr<BreadthFirstSearch<int>>> cache{};
+
+    auto& bfs = cache[threadCount];
+    if (!bfs) {
+        bfs = std::make_unique<BreadthFirstSearch<int>>(randomUnweightedEdges(), threadCount);
+    }
+
+    return *bfs;
+}
+
+
+static void BM_BreadthFirstSearch(benchmark::State& state) {
+    auto& bfs = randomBreadthFirstSearch(state.range(0));
+    std::mt19937 random{29};
+
+    for (auto _ : state) {
+        int source = static_cast<int>(random() % (1 << 20));
+        int target = static_cast<int>(random() % (1 << 20));
+
+        auto path = bfs.getShortestPathBetween(source, target);
+        benchmark::DoNotOptimize(path.data());
+    }
+}
+
+
+BENCHMARK(BM_BreadthFirstSearch)
+    ->ArgName("threads")
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+
+static void BM_BreadthFirstSearchDirection(benchmark::State& state) {
+    auto& bfs = randomBreadthFirstSearch(1);
+    bool bidirectional = state.range(0) == 1;
+    std::mt19937 random{29};
+    SearchStatistics statistics{};
+
+    for (auto _ : state) {
+        int source = static_cast<int>(random() % (1 << 20));
+        int target = static_cast<int>(random() % (1 << 20));
+
+        auto path = bidirectional
+            ? bfs.getShortestPathBidirectional(source, target, &statistics)
+            : bfs.getShortestPathBetween(source, target, &statistics);
+        benchmark::DoNotOptimize(path.data());
+    }
+
+    state.counters["explored"] = benchmark::Counter(statistics.exploredVertices, benchmark::Counter::kAvgIterations);
+}
+
+
+static void BM_PathFinderDirection(benchmark::State& state) {
+    auto& pathfinder = randomPathFinder(1 << 20);
+    int vertexCount = randomWeightedGraph(1 << 20).vertexCount;
+    bool bidirectional = state.range(0) == 1;
+    auto filter = [](int x) { return x > 15; };
+    std::mt19937 random{11};
+    SearchStatistics statistics{};
+
+    for (auto _ : state) {
+        int source = static_cast<int>(random() % vertexCount);
+        int target = static_cast<int>(random() % vertexCount);
+
+        auto path = bidirectional
+            ? pathfinder.findBidirectional(source, target, filter, &statistics)
+            : pathfinder.find(source, target, filter, &statistics);
+        benchmark::DoNotOptimize(path.data());
+    }
+
+    state.counters["explored"] = benchmark::Counter(statistics.exploredVertices, benchmark::Counter::kAvgIterations);
+}
+
+
+BENCHMARK(BM_BreadthFirstSearchDirection)->ArgName("bidirectional")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathFinderDirection)->ArgName("bidirectional")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+
+std::vector<std::pair<int, int>> randomQueries(std::size_t count, int distinctSources) {
+    std::mt19937 random{53};
+    std::vector<std::pair<int, int>> queries{};
+
+    for (std::size_t i = 0; i < count; i++) {
+        queries.push_back({static_cast<int>(random() % distinctSources), static_cast<int>(random() % (1 << 20))});
+    }
+
+    return queries;
+}
+
+
+static void BM_BreadthFirstSearchQueryLoop(benchmark::State& state) {
+    auto& bfs = randomBreadthFirstSearch(1);
+    auto queries = randomQueries(64, state.range(0));
+    LevelWorkspace workspace{};
+
+    for (auto _ : state) {
+        for (auto& [source, target] : queries) {
+            auto path = bfs.getShortestPathBetween(source, target, workspace);
+            benchmark::DoNotOptimize(path.data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+
+// Same queries as BM_BreadthFirstSearchQueryLoop, which is the bar: the
+// batch must never be slower than answering them one at a time. With 4
+// sources it runs 4 traversals instead of 64; with 64 sources every group
+// holds one query and the two should match.
+static void BM_BreadthFirstSearchBatch(benchmark::State& state) {
+    auto& bfs = randomBreadthFirstSearch(1);
+    auto queries = randomQueries(64, state.range(0));
+
+    for (auto _ : state) {
+        auto paths = bfs.getShortestPathsBetween(queries);
+        benchmark::DoNotOptimize(paths.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+
+BENCHMARK(BM_BreadthFirstSearchQueryLoop)->ArgName("sources")->Arg(4)->Arg(64)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BreadthFirstSearchBatch)->ArgName("sources")->Arg(4)->Arg(64)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,256 @@
+#include <benchmark/benchmark.h>
+
+#include "arena.h"
+#include "ref_counted_pointer.h"
+#include "smart_pointers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// Allocates a pointee, hands it through a chain of moves and destroys it.
+// Construction and destruction dominate, so this mostly measures new/delete
+// plus whatever the pointer adds on top.
+template <typename Pointer, typename Make>
+void moveChain(benchmark::State& state, const Make& make) {
+    for (auto _ : state) {
+        Pointer first = make();
+        Pointer second = std::move(first);
+        Pointer third = std::move(second);
+        benchmark::DoNotOptimize(third);
+    }
+}
+
+static void BM_StdUniquePointerMoves(benchmark::State& state) {
+    moveChain<std::unique_ptr<std::string>>(state, [] { return std::make_unique<std::string>("pointee"); });
+}
+
+static void BM_CustomUniquePointerMoves(benchmark::State& state) {
+    moveChain<CustomUniquePointer<std::string*>>(state, [] { return CustomUniquePointer<std::string*>{new std::string("pointee")}; });
+}
+
+static void BM_RValueMoveMoves(benchmark::State& state) {
+    moveChain<RValueMove<std::string>>(state, [] { return RValueMove<std::string>{new std::string("pointee")}; });
+}
+
+static void BM_AutoPointerCopies(benchmark::State& state) {
+    for (auto _ : state) {
+        AutoPointer<std::string> first{new std::string("pointee")};
+        AutoPointer<std::string> second = first;
+        AutoPointer<std::string> third = second;
+        benchmark::DoNotOptimize(third);
+    }
+}
+
+BENCHMARK(BM_StdUniquePointerMoves);
+BENCHMARK(BM_CustomUniquePointerMoves);
+BENCHMARK(BM_RValueMoveMoves);
+BENCHMARK(BM_AutoPointerCopies);
+
+
+// Growing a vector of owners relocates every element on reallocation, which
+// is only cheap when the move constructor is noexcept.
+template <typename Pointer, typename Make>
+void fillVector(benchmark::State& state, const Make& make) {
+    auto count = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state) {
+        std::vector<Pointer> pointers{};
+
+        for (std::size_t i = 0; i < count; i++) {
+            pointers.push_back(make());
+        }
+
+        benchmark::DoNotOptimize(pointers.data());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+static void BM_StdUniquePointerVector(benchmark::State& state) {
+    fillVector<std::unique_ptr<int>>(state, [] { return std::make_unique<int>(1); });
+}
+
+static void BM_CustomUniquePointerVector(benchmark::State& state) {
+    fillVector<CustomUniquePointer<int*>>(state, [] { return CustomUniquePointer<int*>{new int(1)}; });
+}
+
+static void BM_RValueMoveVector(benchmark::State& state) {
+    fillVector<RValueMove<int>>(state, [] { return RValueMove<int>{new int(1)}; });
+}
+
+BENCHMARK(BM_StdUniquePointerVector)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_CustomUniquePointerVector)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_RValueMoveVector)->Arg(1 << 10)->Arg(1 << 16);
+
+
+static void BM_StdSharedPointerCopies(benchmark::State& state) {
+    auto shared = std::make_shared<std::string>("pointee");
+
+    for (auto _ : state) {
+        auto copy = shared;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+static void BM_RefCountedPointerCopies(benchmark::State& state) {
+    auto shared = makeRefCounted<std::string>("pointee");
+
+    for (auto _ : state) {
+        auto copy = shared;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+BENCHMARK(BM_StdSharedPointerCopies)->Threads(1)->Threads(4);
+BENCHMARK(BM_RefCountedPointerCopies)->Threads(1)->Threads(4);
+
+
+// Readers loading the current value of a slot that a writer replaces now
+// and then, as workers do with a published snapshot.
+static void BM_StdAtomicSharedPointerLoad(benchmark::State& state) {
+    static std::atomic<std::shared_ptr<const std::string>> slot{std::make_shared<const std::string>("snapshot")};
+
+    for (auto _ : state) {
+        auto current = slot.load();
+        benchmark::DoNotOptimize(current);
+
+        if (state.thread_index() == 0 && state.iterations() % 1024 == 0) {
+            slot.store(std::make_shared<const std::string>("snapshot"));
+        }
+    }
+}
+
+static void BM_AtomicRefCountedPointerLoad(benchmark::State& state) {
+    static AtomicRefCountedPointer<const std::string> slot{makeRefCounted<const std::string>("snapshot")};
+
+    for (auto _ : state) {
+        auto current = slot.load();
+        benchmark::DoNotOptimize(current);
+
+        if (state.thread_index() == 0 && state.iterations() % 1024 == 0) {
+            slot.store(makeRefCounted<const std::string>("snapshot"));
+        }
+    }
+}
+
+BENCHMARK(BM_StdAtomicSharedPointerLoad)->Threads(1)->Threads(4);
+BENCHMARK(BM_AtomicRefCountedPointerLoad)->Threads(1)->Threads(4);
+
+
+// A batch of short-lived objects owned by RValueMove and dropped together,
+// with the three ways of getting their memory.
+struct SmallResource {
+    int x = 5;
+    double payload[3]{};
+};
+
+template <typename Pointer, typename Make, typename Recycle>
+void ownBatch(benchmark::State& state, const Make& make, const Recycle& recycle) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<Pointer> pointers{};
+    pointers.reserve(count);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < count; i++) {
+            pointers.push_back(make());
+        }
+
+        benchmark::DoNotOptimize(pointers.data());
+        pointers.clear();
+        recycle();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+static void BM_BatchGlobalHeap(benchmark::State& state) {
+    ownBatch<RValueMove<SmallResource>>(state, [] { return RValueMove<SmallResource>{new SmallResource()}; }, [] {});
+}
+
+static void BM_BatchObjectPool(benchmark::State& state) {
+    ObjectPool<SmallResource> pool{4096};
+    using Pointer = RValueMove<SmallResource, PoolDelete<SmallResource>>;
+
+    ownBatch<Pointer>(state, [&pool] { return Pointer{pool.create(), PoolDelete{pool}}; }, [] {});
+}
+
+static void BM_BatchMonotonicArena(benchmark::State& state) {
+    MonotonicArena arena{};
+    using Pointer = RValueMove<SmallResource, ArenaDelete<SmallResource>>;
+
+    ownBatch<Pointer>(state, [&arena] { return Pointer{arena.create<SmallResource>()}; }, [&arena] { arena.reset(); });
+}
+
+BENCHMARK(BM_BatchGlobalHeap)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BatchObjectPool)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BatchMonotonicArena)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+
+// Walks a vector of handles whose order has been shuffled, as it is after
+// a container has been sorted or rebuilt a few times. Heap pointees are
+// then visited out of allocation order and most reads miss the cache.
+template <typename Handle, typename Make, typename Read>
+void dereferenceShuffled(benchmark::State& state, const Make& make, const Read& read) {
+    auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<Handle> handles{};
+    handles.reserve(count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        handles.push_back(make(i));
+    }
+
+    std::shuffle(handles.begin(), handles.end(), std::mt19937{5});
+
+    for (auto _ : state) {
+        std::size_t total = 0;
+        for (const auto& handle : handles) {
+            total += read(handle);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+static void BM_DereferenceCustomUniquePointerInt(benchmark::State& state) {
+    dereferenceShuffled<CustomUniquePointer<int*>>(
+        state,
+        [](std::size_t i) { return CustomUniquePointer<int*>{new int(static_cast<int>(i))}; },
+        [](const auto& handle) { return static_cast<std::size_t>(*handle); }
+    );
+}
+
+static void BM_DereferenceInlineUniquePointerInt(benchmark::State& state) {
+    dereferenceShuffled<InlineUniquePointer<int>>(
+        state,
+        [](std::size_t i) { return makeInlineUnique<int>(static_cast<int>(i)); },
+        [](const auto& handle) { return static_cast<std::size_t>(*handle); }
+    );
+}
+
+static void BM_DereferenceCustomUniquePointerString(benchmark::State& state) {
+    dereferenceShuffled<CustomUniquePointer<std::string*>>(
+        state,
+        [](std::size_t i) { return CustomUniquePointer<std::string*>{new std::string(std::to_string(i))}; },
+        [](const auto& handle) { return (*handle).size(); }
+    );
+}
+
+static void BM_DereferenceInlineUniquePointerString(benchmark::State& state) {
+    dereferenceShuffled<InlineUniquePointer<std::string>>(
+        state,
+        [](std::size_t i) { return makeInlineUnique<std::string>(std::to_string(i)); },
+        [](const auto& handle) { return handle->size(); }
+    );
+}
+
+BENCHMARK(BM_DereferenceCustomUniquePointerInt)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_DereferenceInlineUniquePointerInt)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_DereferenceCustomUniquePointerString)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_DereferenceInlineUniquePointerString)->Arg(1 << 10)->Arg(1 << 20);
@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include "string_column.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// 4M short strings of 1 to 12 characters.
+const std::vector<std::string>& shortStrings() {
+    static std::vector<std::string> strings = [] {
+        std::mt19937 random{53};
+        std::vector<std::string> strings(std::size_t{1} << 22);
+
+        for (auto& string : strings) {
+            auto length = random() % 12 + 1;
+            for (std::size_t i = 0; i < length; i++) {
+                string.push_back(static_cast<char>('a' + random() % 4));
+            }
+        }
+
+        return strings;
+    }();
+
+    return strings;
+}
+
+const StringColumn& shortStringColumn() {
+    static StringColumn column{shortStrings()};
+    return column;
+}
+
+
+static void BM_BuildStringColumn(benchmark::State& state) {
+    const auto& strings = shortStrings();
+
+    for (auto _ : state) {
+        StringColumn column{strings};
+        benchmark::DoNotOptimize(column.characterData());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * strings.size()));
+}
+
+
+static void BM_ShortestStringAccumulate(benchmark::State& state) {
+    const auto& strings = shortStrings();
+
+    for (auto _ : state) {
+        auto shortest = std::accumulate(strings.begin(), strings.end(), std::numeric_limits<std::size_t>::max(), [](std::size_t lowest, const std::string& current) {
+            return std::min(lowest, current.length());
+        });
+        benchmark::DoNotOptimize(shortest);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * strings.size()));
+}
+
+static void BM_StringColumnLengthBounds(benchmark::State& state) {
+    const auto& column = shortStringColumn();
+    auto level = static_cast<SimdLevel>(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lengthBounds(column, level));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * column.size()));
+}
+
+
+static void BM_CountEqualStrings(benchmark::State& state) {
+    const auto& strings = shortStrings();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::count(strings.begin(), strings.end(), "abca"));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * strings.size()));
+}
+
+static void BM_StringColumnSelectEqual(benchmark::State& state) {
+    const auto& column = shortStringColumn();
+    auto level = static_cast<SimdLevel>(state.range(0));
+    std::vector<std::uint64_t> mask{};
+
+    for (auto _ : state) {
+        selectEqual(column, "abca", mask, level);
+        benchmark::DoNotOptimize(mask.data());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * column.size()));
+}
+
+
+static void BM_StringColumnSelectLengths(benchmark::State& state) {
+    const auto& column = shortStringColumn();
+    auto level = static_cast<SimdLevel>(state.range(0));
+    std::vector<std::uint64_t> mask{};
+
+    for (auto _ : state) {
+        selectLengths(column, 3, 6, mask, level);
+        benchmark::DoNotOptimize(mask.data());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * column.size()));
+}
+
+
+const std::vector<std::int64_t> STRING_KERNEL_LEVELS{
+    static_cast<int>(SimdLevel::Scalar),
+    static_cast<int>(SimdLevel::Sse41),
+    static_cast<int>(SimdLevel::Avx2),
+};
+
+BENCHMARK(BM_BuildStringColumn)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ShortestStringAccumulate)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StringColumnLengthBounds)->ArgName("level")->ArgsProduct({STRING_KERNEL_LEVELS})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CountEqualStrings)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StringColumnSelectEqual)->ArgName("level")->ArgsProduct({STRING_KERNEL_LEVELS})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StringColumnSelectLengths)->ArgName("level")->ArgsProduct({STRING_KERNEL_LEVELS})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include "weight_filters.h"
+
+#include <random>
+#include <vector>
+
+
+const std::vector<int>& randomWeights() {
+    static std::vector<int> weights = [] {
+        std::mt19937 random{13};
+        std::vector<int> generated(10'000'000);
+
+        for (auto& weight : generated) {
+            weight = static_cast<int>(random() % 100 + 1);
+        }
+
+        return generated;
+    }();
+
+    return weights;
+}
+
+
+static void BM_SelectWeights(benchmark::State& state) {
+    auto level = static_cast<SimdLevel>(state.range(0));
+    if (level > detectedSimdLevel()) {
+        state.SkipWithError("SIMD level not supported by this CPU");
+        return;
+    }
+
+    std::span<const int> weights(randomWeights());
+    std::vector<std::uint64_t> mask{};
+
+    for (auto _ : state) {
+        selectWeights(weights, WeightAbove<int>{15}, mask, level);
+        benchmark::DoNotOptimize(mask.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * weights.size());
+}
+
+
+BENCHMARK(BM_SelectWeights)
+    ->ArgName("level")
+    ->Arg(static_cast<int>(SimdLevel::Scalar))
+    ->Arg(static_cast<int>(SimdLevel::Sse41))
+    ->Arg(static_cast<int>(SimdLevel::Avx2))
+    ->Unit(benchmark::kMillisecond);
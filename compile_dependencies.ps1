@@ -16,3 +16,15 @@ cmake -S . -B build -G "MinGW Makefiles" -D CMAKE_CXX_COMPILER=g++ -D CMAKE_C_CO
 cmake --build build --config Debug
 
 set-location $current_loc
+
+Invoke-WebRequest https://github.com/google/benchmark/archive/refs/tags/v1.8.3.zip -OutFile build/dependencies/benchmark.zip
+
+Expand-Archive build/dependencies/benchmark.zip build/dependencies/benchmark
+
+set-location .\build\dependencies\benchmark\
+set-location $(Get-ChildItem)
+
+cmake -S . -B build -G "MinGW Makefiles" -D CMAKE_CXX_COMPILER=g++ -D CMAKE_C_COMPILER=gcc -D CMAKE_BUILD_TYPE=Release -D BENCHMARK_ENABLE_TESTING=OFF
+cmake --build build --config Release
+
+set-location $current_loc
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+// Bump allocator over a list of chunks. Individual objects are never freed;
+// reset() rewinds to the first chunk so the memory is reused, and the
+// destructor returns every chunk at once. Destructors of objects created
+// here only run if their owner calls them, e.g. through ArenaDelete.
+class MonotonicArena {
+public:
+    explicit MonotonicArena(std::size_t initialChunkSize = std::size_t{64} << 10)
+        : nextChunkSize(std::max<std::size_t>(initialChunkSize, 64)) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        void* memory = alignedCursor(size, alignment);
+
+        if (memory == nullptr) {
+            useChunk(size + alignment);
+            memory = alignedCursor(size, alignment);
+        }
+
+        cursor = static_cast<std::byte*>(memory) + size;
+        return memory;
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Everything allocated so far becomes invalid.
+    void reset() {
+        usedChunks = 0;
+        cursor = nullptr;
+        end = nullptr;
+    }
+
+    std::size_t capacity() const {
+        std::size_t total = 0;
+        for (const auto& chunk : chunks) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t size;
+    };
+
+    std::vector<Chunk> chunks{};
+    std::size_t usedChunks = 0;
+    std::size_t nextChunkSize;
+    std::byte* cursor = nullptr;
+    std::byte* end = nullptr;
+
+    void* alignedCursor(std::size_t size, std::size_t alignment) {
+        if (cursor == nullptr) {
+            return nullptr;
+        }
+
+        void* memory = cursor;
+        std::size_t space = static_cast<std::size_t>(end - cursor);
+        return std::align(alignment, size, memory, space);
+    }
+
+    // Chunks kept from before a reset that are too small are skipped until
+    // the next reset.
+    void useChunk(std::size_t minimumSize) {
+        while (usedChunks < chunks.size() && chunks[usedChunks].size < minimumSize) {
+            usedChunks++;
+        }
+
+        if (usedChunks == chunks.size()) {
+            auto size = std::max(nextChunkSize, minimumSize);
+            chunks.push_back(Chunk{std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+            nextChunkSize = size * 2;
+        }
+
+        cursor = chunks[usedChunks].memory.get();
+        end = cursor + chunks[usedChunks].size;
+        usedChunks++;
+    }
+};
+
+
+// Fixed-size slots for one type, recycled through a free list. Memory goes
+// back to the system only when the pool is destroyed, which must happen
+// after every object in it has been destroyed.
+template <typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(std::size_t slotsPerChunk = 1024)
+        : slotsPerChunk(std::max<std::size_t>(slotsPerChunk, 1)) {}
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        auto slot = take();
+
+        try {
+            return new (slot->storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            give(slot);
+            throw;
+        }
+    }
+
+    void destroy(T* object) {
+        object->~T();
+        give(reinterpret_cast<Slot*>(object));
+    }
+
+    std::size_t capacity() const {
+        return chunks.size() * slotsPerChunk;
+    }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> chunks{};
+    std::size_t slotsPerChunk;
+    Slot* freeList = nullptr;
+
+    Slot* take() {
+        if (freeList == nullptr) {
+            chunks.emplace_back(new Slot[slotsPerChunk]);
+
+            for (std::size_t i = slotsPerChunk; i-- > 0;) {
+                give(&chunks.back()[i]);
+            }
+        }
+
+        return std::exchange(freeList, freeList->next);
+    }
+
+    void give(Slot* slot) {
+        slot->next = freeList;
+        freeList = slot;
+    }
+};
+
+
+// Deleters for the smart pointers in smart_pointers.h. ArenaDelete only runs
+// the destructor and leaves the memory to the arena, so it takes no space in
+// the pointer; PoolDelete hands the slot back to its pool.
+template <typename T>
+struct ArenaDelete {
+    void operator()(T* object) const {
+        object->~T();
+    }
+};
+
+
+template <typename T>
+class PoolDelete {
+public:
+    explicit PoolDelete(ObjectPool<T>& pool) : pool(&pool) {}
+
+    void operator()(T* object) const {
+        pool->destroy(object);
+    }
+
+private:
+    ObjectPool<T>* pool;
+};
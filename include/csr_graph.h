@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+class CsrGraph {
+public:
+    using VertexId = std::uint32_t;
+
+    CsrGraph() = default;
+
+    CsrGraph(VertexId vertexCount, const std::vector<std::pair<VertexId, VertexId>>& edges) {
+        build(vertexCount, edges, [this](const auto& edge, std::size_t slot) {
+            neighbors[slot] = edge.second;
+        });
+    }
+
+    VertexId vertexCount() const {
+        return offsets.empty() ? 0 : static_cast<VertexId>(offsets.size() - 1);
+    }
+
+    std::size_t edgeCount() const {
+        return neighbors.size();
+    }
+
+    std::size_t firstEdgeOf(VertexId vertex) const {
+        return offsets[vertex];
+    }
+
+    std::size_t lastEdgeOf(VertexId vertex) const {
+        return offsets[vertex + 1];
+    }
+
+    std::span<const VertexId> neighborsOf(VertexId vertex) const {
+        return std::span<const VertexId>(neighbors).subspan(
+            firstEdgeOf(vertex),
+            lastEdgeOf(vertex) - firstEdgeOf(vertex)
+        );
+    }
+
+    std::span<const std::uint64_t> allOffsets() const {
+        return offsets;
+    }
+
+    std::span<const VertexId> allNeighbors() const {
+        return neighbors;
+    }
+
+protected:
+    std::vector<std::uint64_t> offsets{};
+    std::vector<VertexId> neighbors{};
+
+    // Counting sort by source vertex, stable within each source.
+    template <typename Edges, typename Place>
+    void build(VertexId vertexCount, const Edges& edges, Place place) {
+        offsets.assign(static_cast<std::size_t>(vertexCount) + 1, 0);
+        neighbors.resize(edges.size());
+
+        for (auto& edge : edges) {
+            if (std::get<0>(edge) >= vertexCount || std::get<1>(edge) >= vertexCount) {
+                throw std::out_of_range("CsrGraph: edge endpoint outside of vertex range");
+            }
+
+            offsets[std::get<0>(edge) + 1]++;
+        }
+
+        for (std::size_t i = 1; i < offsets.size(); i++) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        std::vector<std::uint64_t> cursors(offsets.begin(), offsets.end() - 1);
+
+        for (auto& edge : edges) {
+            place(edge, cursors[std::get<0>(edge)]++);
+        }
+    }
+};
+
+
+template <typename E>
+struct WeightedEdge {
+    CsrGraph::VertexId source;
+    CsrGraph::VertexId target;
+    const E& weight;
+    std::size_t index;
+};
+
+
+template <typename E>
+class WeightedCsrGraph : public CsrGraph {
+public:
+    WeightedCsrGraph() = default;
+
+    WeightedCsrGraph(VertexId vertexCount, const std::vector<std::tuple<VertexId, VertexId, E>>& edges) {
+        weights.resize(edges.size());
+
+        build(vertexCount, edges, [this](const auto& edge, std::size_t slot) {
+            neighbors[slot] = std::get<1>(edge);
+            weights[slot] = std::get<2>(edge);
+        });
+    }
+
+    std::span<const E> weightsOf(VertexId vertex) const {
+        return std::span<const E>(weights).subspan(
+            firstEdgeOf(vertex),
+            lastEdgeOf(vertex) - firstEdgeOf(vertex)
+        );
+    }
+
+    std::span<const E> allWeights() const {
+        return weights;
+    }
+
+    // Lazy views over the stored arrays; iterating them never allocates and
+    // they compose with std::views::filter and friends.
+    auto edgesOf(VertexId vertex) const {
+        return std::views::iota(firstEdgeOf(vertex), lastEdgeOf(vertex))
+            | std::views::transform([this, vertex](std::size_t edge) {
+                return WeightedEdge<E>{vertex, neighbors[edge], weights[edge], edge};
+            });
+    }
+
+    auto edges() const {
+        return std::views::iota(VertexId{0}, vertexCount())
+            | std::views::transform([this](VertexId vertex) {
+                return edgesOf(vertex);
+            })
+            | std::views::join;
+    }
+
+private:
+    std::vector<E> weights{};
+};
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "csr_graph.h"
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+// CSR layout where every row may have spare capacity, so edges can be
+// inserted and erased in place. A full row is moved to the end of the
+// arrays with twice the room, which keeps inserts amortized O(1) and rows
+// contiguous for scans. Erasing swaps the last edge of the row into the
+// hole, after a scan of that one row. Abandoned rows are garbage until
+// they outweigh the live edges and the arrays are compacted.
+class DynamicCsrGraph {
+public:
+    using VertexId = CsrGraph::VertexId;
+
+    DynamicCsrGraph() = default;
+
+    DynamicCsrGraph(VertexId vertexCount, const std::vector<std::pair<VertexId, VertexId>>& edges)
+        : DynamicCsrGraph(CsrGraph(vertexCount, edges)) {}
+
+    explicit DynamicCsrGraph(const CsrGraph& graph) {
+        adoptRows(graph);
+
+        for (VertexId vertex = 0; vertex < graph.vertexCount(); vertex++) {
+            auto row = graph.neighborsOf(vertex);
+            std::copy(row.begin(), row.end(), neighbors.begin() + rowBegin[vertex]);
+        }
+    }
+
+    VertexId vertexCount() const {
+        return static_cast<VertexId>(rowBegin.size());
+    }
+
+    std::size_t edgeCount() const {
+        return liveEdges;
+    }
+
+    std::size_t firstEdgeOf(VertexId vertex) const {
+        return rowBegin[vertex];
+    }
+
+    std::size_t lastEdgeOf(VertexId vertex) const {
+        return rowBegin[vertex] + rowSize[vertex];
+    }
+
+    std::span<const VertexId> neighborsOf(VertexId vertex) const {
+        return std::span<const VertexId>(neighbors).subspan(rowBegin[vertex], rowSize[vertex]);
+    }
+
+    // Bumped every time the arrays are repacked and edge slots change.
+    std::uint64_t compactions() const {
+        return compactionCount;
+    }
+
+    void addVertices(VertexId vertexCount) {
+        if (vertexCount > this->vertexCount()) {
+            rowBegin.resize(vertexCount, neighbors.size());
+            rowSize.resize(vertexCount, 0);
+            rowCapacity.resize(vertexCount, 0);
+        }
+    }
+
+    void insert(VertexId from, VertexId to) {
+        claimSlot(from, to, [](std::size_t, std::size_t) {}, [](std::size_t) {});
+
+        if (isWasteful()) {
+            compact([](std::size_t, std::size_t) {});
+        }
+    }
+
+    bool erase(VertexId from, VertexId to) {
+        auto slot = findSlot(from, [to, this](std::size_t slot) {
+            return neighbors[slot] == to;
+        });
+
+        if (slot == NO_SLOT) {
+            return false;
+        }
+
+        releaseSlot(from, slot, [](std::size_t, std::size_t) {});
+        return true;
+    }
+
+protected:
+    static constexpr std::size_t NO_SLOT = static_cast<std::size_t>(-1);
+    static constexpr std::uint32_t MINIMUM_CAPACITY = 4;
+
+    std::vector<std::uint64_t> rowBegin{};
+    std::vector<std::uint32_t> rowSize{};
+    std::vector<std::uint32_t> rowCapacity{};
+    std::vector<VertexId> neighbors{};
+    std::size_t liveEdges = 0;
+    std::size_t garbage = 0;
+    std::uint64_t compactionCount = 0;
+
+    void adoptRows(const CsrGraph& graph) {
+        rowBegin.resize(graph.vertexCount());
+        rowSize.resize(graph.vertexCount());
+        rowCapacity.resize(graph.vertexCount());
+        neighbors.resize(graph.edgeCount());
+        liveEdges = graph.edgeCount();
+
+        for (VertexId vertex = 0; vertex < graph.vertexCount(); vertex++) {
+            rowBegin[vertex] = graph.firstEdgeOf(vertex);
+            rowSize[vertex] = static_cast<std::uint32_t>(graph.lastEdgeOf(vertex) - graph.firstEdgeOf(vertex));
+            rowCapacity[vertex] = rowSize[vertex];
+        }
+    }
+
+    void checkVertex(VertexId vertex) const {
+        if (vertex >= vertexCount()) {
+            throw std::out_of_range("DynamicCsrGraph: vertex outside of vertex range");
+        }
+    }
+
+    template <typename Matches>
+    std::size_t findSlot(VertexId from, const Matches& matches) const {
+        if (from >= vertexCount()) {
+            return NO_SLOT;
+        }
+
+        for (auto slot = firstEdgeOf(from); slot < lastEdgeOf(from); slot++) {
+            if (matches(slot)) {
+                return slot;
+            }
+        }
+
+        return NO_SLOT;
+    }
+
+    // moveSlot copies any per-edge payload when the row is relocated and
+    // growStorage resizes payload columns to match the neighbor array.
+    template <typename MoveSlot, typename GrowStorage>
+    std::size_t claimSlot(VertexId from, VertexId to, const MoveSlot& moveSlot, const GrowStorage& growStorage) {
+        checkVertex(from);
+        checkVertex(to);
+
+        if (rowSize[from] == rowCapacity[from]) {
+            std::uint32_t capacity = std::max(rowCapacity[from] * 2, MINIMUM_CAPACITY);
+            std::size_t begin = neighbors.size();
+
+            neighbors.resize(begin + capacity);
+            growStorage(neighbors.size());
+
+            for (std::uint32_t i = 0; i < rowSize[from]; i++) {
+                neighbors[begin + i] = neighbors[rowBegin[from] + i];
+                moveSlot(rowBegin[from] + i, begin + i);
+            }
+
+            garbage += rowCapacity[from];
+            rowBegin[from] = begin;
+            rowCapacity[from] = capacity;
+        }
+
+        auto slot = rowBegin[from] + rowSize[from]++;
+        neighbors[slot] = to;
+        liveEdges++;
+
+        return slot;
+    }
+
+    template <typename MoveSlot>
+    void releaseSlot(VertexId from, std::size_t slot, const MoveSlot& moveSlot) {
+        auto last = lastEdgeOf(from) - 1;
+
+        neighbors[slot] = neighbors[last];
+        moveSlot(last, slot);
+
+        rowSize[from]--;
+        liveEdges--;
+    }
+
+    bool isWasteful() const {
+        return garbage > liveEdges + 1024;
+    }
+
+    template <typename MoveSlot>
+    void compact(const MoveSlot& moveSlot) {
+        std::vector<VertexId> packed(liveEdges);
+        std::size_t cursor = 0;
+
+        for (VertexId vertex = 0; vertex < vertexCount(); vertex++) {
+            for (std::uint32_t i = 0; i < rowSize[vertex]; i++) {
+                packed[cursor + i] = neighbors[rowBegin[vertex] + i];
+                moveSlot(rowBegin[vertex] + i, cursor + i);
+            }
+
+            rowBegin[vertex] = cursor;
+            rowCapacity[vertex] = rowSize[vertex];
+            cursor += rowSize[vertex];
+        }
+
+        neighbors = std::move(packed);
+        garbage = 0;
+        compactionCount++;
+    }
+};
+
+
+template <typename E>
+class DynamicWeightedCsrGraph : public DynamicCsrGraph {
+public:
+    DynamicWeightedCsrGraph() = default;
+
+    DynamicWeightedCsrGraph(VertexId vertexCount, const std::vector<std::tuple<VertexId, VertexId, E>>& edges) {
+        WeightedCsrGraph<E> graph{vertexCount, edges};
+        adoptRows(graph);
+        weights.resize(graph.edgeCount());
+
+        for (VertexId vertex = 0; vertex < graph.vertexCount(); vertex++) {
+            auto row = graph.neighborsOf(vertex);
+            auto rowWeights = graph.weightsOf(vertex);
+
+            std::copy(row.begin(), row.end(), neighbors.begin() + rowBegin[vertex]);
+            std::copy(rowWeights.begin(), rowWeights.end(), weights.begin() + rowBegin[vertex]);
+        }
+    }
+
+    void insert(VertexId from, VertexId to, const E& weight) {
+        auto slot = claimSlot(from, to, moveWeight(), [this](std::size_t size) {
+            weights.resize(size);
+        });
+        weights[slot] = weight;
+
+        compactWeightsIfWasteful();
+    }
+
+    bool erase(VertexId from, VertexId to, const E& weight) {
+        auto slot = findSlot(from, [&](std::size_t slot) {
+            return neighbors[slot] == to && weights[slot] == weight;
+        });
+
+        if (slot == NO_SLOT) {
+            return false;
+        }
+
+        releaseSlot(from, slot, moveWeight());
+        return true;
+    }
+
+    std::span<const E> weightsOf(VertexId vertex) const {
+        return std::span<const E>(weights).subspan(rowBegin[vertex], rowSize[vertex]);
+    }
+
+    // Includes unused slots; only indices reached through a row are live.
+    std::span<const E> allWeights() const {
+        return weights;
+    }
+
+    auto edgesOf(VertexId vertex) const {
+        return std::views::iota(firstEdgeOf(vertex), lastEdgeOf(vertex))
+            | std::views::transform([this, vertex](std::size_t edge) {
+                return WeightedEdge<E>{vertex, neighbors[edge], weights[edge], edge};
+            });
+    }
+
+    auto edges() const {
+        return std::views::iota(VertexId{0}, vertexCount())
+            | std::views::transform([this](VertexId vertex) {
+                return edgesOf(vertex);
+            })
+            | std::views::join;
+    }
+
+private:
+    std::vector<E> weights{};
+
+    auto moveWeight() {
+        return [this](std::size_t from, std::size_t to) {
+            weights[to] = weights[from];
+        };
+    }
+
+    void compactWeightsIfWasteful() {
+        if (!isWasteful()) {
+            return;
+        }
+
+        std::vector<E> packed(liveEdges);
+
+        compact([&](std::size_t from, std::size_t to) {
+            packed[to] = weights[from];
+        });
+
+        weights = std::move(packed);
+    }
+};
+
+
+// Graphs that PathFinder and BreadthFirstSearch update in place.
+template <typename Graph>
+concept DynamicGraph = std::derived_from<Graph, DynamicCsrGraph>;
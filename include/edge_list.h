@@ -0,0 +1,475 @@
+#pragma once
+
+#include "csr_graph.h"
+#include "graph_snapshot.h"
+#include "vertex_interner.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <queue>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+struct IngestStatistics {
+    std::size_t bytes = 0;
+    std::size_t edges = 0;
+    double seconds = 0;
+
+    // Decimal megabytes, 10^6 bytes.
+    double megabytesPerSecond() const {
+        return seconds > 0 ? static_cast<double>(bytes) / 1e6 / seconds : 0;
+    }
+};
+
+
+// Parses a text field as a vertex label or weight. Strings are copied,
+// arithmetic types go through from_chars without allocating.
+template <typename T>
+T parseField(std::string_view field) {
+    if constexpr (std::constructible_from<T, std::string_view> && !std::is_arithmetic_v<T>) {
+        return T(field);
+    } else {
+        static_assert(std::is_arithmetic_v<T>, "edge list fields must be strings or numbers");
+
+        T value{};
+        auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+
+        if (error != std::errc{} || end != field.data() + field.size()) {
+            throw std::runtime_error("EdgeListReader: cannot parse field '" + std::string(field) + "'");
+        }
+
+        return value;
+    }
+}
+
+
+// Reads "from to [weight]" lines in fixed-size chunks, so memory use does
+// not depend on the file size. Fields are separated by spaces or tabs;
+// blank lines and lines starting with '#' are skipped. A line longer than
+// a chunk grows the buffer to fit it.
+class EdgeListReader {
+public:
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+    explicit EdgeListReader(const std::string& path, std::size_t chunkSize = DEFAULT_CHUNK_SIZE)
+        : path(path), input(path, std::ios::binary), buffer(std::max<std::size_t>(chunkSize, 1)) {
+        if (!input) {
+            throw std::runtime_error("EdgeListReader: cannot open " + path);
+        }
+    }
+
+    // Calls onEdge(from, to, weight) with views into the chunk buffer, which
+    // are only valid during the call. weight is empty when a line has no
+    // third field.
+    template <typename OnEdge>
+    IngestStatistics read(const OnEdge& onEdge) {
+        auto start = std::chrono::steady_clock::now();
+        IngestStatistics statistics{};
+        std::size_t carried = 0;
+        std::size_t line = 0;
+
+        while (true) {
+            if (carried == buffer.size()) {
+                buffer.resize(buffer.size() * 2);
+            }
+
+            input.read(buffer.data() + carried, static_cast<std::streamsize>(buffer.size() - carried));
+            auto received = static_cast<std::size_t>(input.gcount());
+            auto filled = carried + received;
+            bool finished = received == 0;
+
+            statistics.bytes += received;
+
+            std::string_view chunk(buffer.data(), filled);
+            std::size_t begin = 0;
+
+            for (auto end = chunk.find('\n'); end != std::string_view::npos; end = chunk.find('\n', begin)) {
+                parseLine(chunk.substr(begin, end - begin), ++line, statistics, onEdge);
+                begin = end + 1;
+            }
+
+            if (finished) {
+                if (begin < filled) {
+                    parseLine(chunk.substr(begin), ++line, statistics, onEdge);
+                }
+                break;
+            }
+
+            carried = filled - begin;
+            std::copy(buffer.begin() + begin, buffer.begin() + filled, buffer.begin());
+        }
+
+        statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return statistics;
+    }
+
+private:
+    std::string path;
+    std::ifstream input;
+    std::vector<char> buffer;
+
+    static std::string_view nextField(std::string_view& rest) {
+        auto begin = rest.find_first_not_of(" \t\r");
+        if (begin == std::string_view::npos) {
+            rest = {};
+            return {};
+        }
+
+        auto end = std::min(rest.find_first_of(" \t\r", begin), rest.size());
+        auto field = rest.substr(begin, end - begin);
+        rest.remove_prefix(end);
+
+        return field;
+    }
+
+    template <typename OnEdge>
+    void parseLine(std::string_view text, std::size_t line, IngestStatistics& statistics, const OnEdge& onEdge) const {
+        auto from = nextField(text);
+        if (from.empty() || from.front() == '#') {
+            return;
+        }
+
+        auto to = nextField(text);
+        auto weight = nextField(text);
+
+        if (to.empty() || !nextField(text).empty()) {
+            throw std::runtime_error("EdgeListReader: " + path + ":" + std::to_string(line) + " is not an edge");
+        }
+
+        onEdge(from, to, weight);
+        statistics.edges++;
+    }
+};
+
+
+// Feeds every edge of the file to pathfinder.add without holding the file
+// in memory.
+template <typename V, typename E, typename PathFinder>
+IngestStatistics ingestEdgeList(
+    const std::string& path,
+    PathFinder& pathfinder,
+    std::size_t chunkSize = EdgeListReader::DEFAULT_CHUNK_SIZE
+) {
+    EdgeListReader reader{path, chunkSize};
+
+    return reader.read([&pathfinder](std::string_view from, std::string_view to, std::string_view weight) {
+        if (weight.empty()) {
+            throw std::runtime_error("ingestEdgeList: edge without a weight");
+        }
+
+        pathfinder.add(parseField<V>(from), parseField<V>(to), parseField<E>(weight));
+    });
+}
+
+
+struct SnapshotBuildOptions {
+    // Bytes of edge records held in memory before they are sorted and
+    // spilled to a run file. Labels and per-vertex degrees are kept in
+    // memory on top of this. Each build writes its runs to a new private
+    // directory under spillDirectory, removed by the next build or when
+    // the builder is destroyed.
+    std::size_t memoryBudget = std::size_t{256} << 20;
+    std::size_t chunkSize = EdgeListReader::DEFAULT_CHUNK_SIZE;
+    std::filesystem::path spillDirectory = std::filesystem::temp_directory_path();
+};
+
+
+// Builds a snapshot straight from an edge list that may not fit in memory.
+// Edges are buffered up to the memory budget, sorted and spilled as runs,
+// once by source and once by target. The runs are then merged straight
+// into the snapshot arrays. Ties keep file order, so a weighted build has
+// the same arrays PathFinder::save writes for the graph built in memory.
+// E = void builds an unweighted snapshot for BreadthFirstSearch.
+template <typename E = void>
+class SnapshotBuilder {
+public:
+    using VertexId = CsrGraph::VertexId;
+
+    static constexpr bool WEIGHTED = !std::is_void_v<E>;
+
+    explicit SnapshotBuilder(SnapshotBuildOptions options = {})
+        : options(std::move(options)) {}
+
+    SnapshotBuilder(const SnapshotBuilder&) = delete;
+    SnapshotBuilder& operator=(const SnapshotBuilder&) = delete;
+
+    ~SnapshotBuilder() {
+        removeRuns();
+    }
+
+    IngestStatistics build(const std::string& edgeListPath, const std::string& snapshotPath) {
+        auto start = std::chrono::steady_clock::now();
+        auto capacity = std::max<std::size_t>(options.memoryBudget / sizeof(Record), 1);
+
+        reset();
+        buffer.reserve(capacity);
+
+        EdgeListReader reader{edgeListPath, options.chunkSize};
+        auto statistics = reader.read([&](std::string_view from, std::string_view to, std::string_view weight) {
+            Record record{interner.intern(from), interner.intern(to)};
+
+            if constexpr (WEIGHTED) {
+                if (weight.empty()) {
+                    throw std::runtime_error("SnapshotBuilder: edge without a weight");
+                }
+                record.weight = parseField<E>(weight);
+            }
+
+            outDegrees.resize(interner.size(), 0);
+            inDegrees.resize(interner.size(), 0);
+            outDegrees[record.from]++;
+            inDegrees[record.to]++;
+
+            buffer.push_back(record);
+            if (buffer.size() == capacity) {
+                spill();
+            }
+        });
+        spill();
+
+        SnapshotWriter writer{snapshotPath, interner.size(), WEIGHTED ? sizeof(Weight) : 0};
+        writer.writeLabels(interner.tables());
+
+        writeSections(writer, forwardRuns, outDegrees, SnapshotSection::Offsets, SnapshotSection::Neighbors, SnapshotSection::Weights);
+        writeSections(writer, reverseRuns, inDegrees, SnapshotSection::ReverseOffsets, SnapshotSection::ReverseNeighbors, SnapshotSection::ReverseWeights);
+        writer.commit();
+
+        statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return statistics;
+    }
+
+    std::size_t runCount() const {
+        return forwardRuns.size();
+    }
+
+private:
+    struct Unweighted {};
+    using Weight = std::conditional_t<WEIGHTED, E, Unweighted>;
+
+    struct Record {
+        VertexId from;
+        VertexId to;
+        [[no_unique_address]] Weight weight{};
+    };
+
+    static constexpr std::size_t RUN_READ_RECORDS = 4096;
+
+    SnapshotBuildOptions options;
+    VertexInterner<std::string> interner{};
+    std::vector<std::uint64_t> outDegrees{};
+    std::vector<std::uint64_t> inDegrees{};
+    std::vector<Record> buffer{};
+    std::vector<std::filesystem::path> forwardRuns{};
+    std::vector<std::filesystem::path> reverseRuns{};
+    std::filesystem::path runDirectory{};
+
+    // Forward runs are ordered by source; reverse runs by target, then by
+    // source as a forward CSR lists them.
+    void spill() {
+        if (buffer.empty()) {
+            return;
+        }
+
+        std::stable_sort(buffer.begin(), buffer.end(), [](const Record& a, const Record& b) {
+            return a.from < b.from;
+        });
+        forwardRuns.push_back(writeRun("forward"));
+
+        std::stable_sort(buffer.begin(), buffer.end(), [](const Record& a, const Record& b) {
+            return a.to < b.to;
+        });
+        reverseRuns.push_back(writeRun("reverse"));
+
+        buffer.clear();
+    }
+
+    // create_directory only succeeds for the caller that made the directory,
+    // so a random name that is taken just means trying another one.
+    const std::filesystem::path& privateRunDirectory() {
+        constexpr int ATTEMPTS = 16;
+
+        if (!runDirectory.empty()) {
+            return runDirectory;
+        }
+
+        std::random_device random{};
+        for (int attempt = 0; attempt < ATTEMPTS; attempt++) {
+            auto name = "snapshot_runs_" + std::to_string((std::uint64_t{random()} << 32) | random());
+            auto candidate = options.spillDirectory / name;
+
+            if (std::filesystem::create_directory(candidate)) {
+                runDirectory = candidate;
+                return runDirectory;
+            }
+        }
+
+        throw std::runtime_error("SnapshotBuilder: cannot create a run directory in " + options.spillDirectory.string());
+    }
+
+    std::filesystem::path writeRun(const char* direction) {
+        auto path = privateRunDirectory() / (std::string(direction) + "_" + std::to_string(forwardRuns.size()) + ".bin");
+
+        std::ofstream output{path, std::ios::binary | std::ios::trunc};
+        output.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(Record)));
+
+        if (!output) {
+            throw std::runtime_error("SnapshotBuilder: cannot write " + path.string());
+        }
+
+        return path;
+    }
+
+    void removeRuns() {
+        if (!runDirectory.empty()) {
+            std::error_code ignored{};
+            std::filesystem::remove_all(runDirectory, ignored);
+        }
+
+        runDirectory.clear();
+        forwardRuns.clear();
+        reverseRuns.clear();
+    }
+
+    void reset() {
+        removeRuns();
+        interner = {};
+        outDegrees.clear();
+        inDegrees.clear();
+        buffer.clear();
+    }
+
+    class RunReader {
+    public:
+        explicit RunReader(const std::filesystem::path& path)
+            : input(path, std::ios::binary), records(RUN_READ_RECORDS) {
+            refill();
+        }
+
+        bool done() const {
+            return position == count;
+        }
+
+        const Record& current() const {
+            return records[position];
+        }
+
+        void advance() {
+            if (++position == count) {
+                refill();
+            }
+        }
+
+    private:
+        std::ifstream input;
+        std::vector<Record> records;
+        std::size_t position = 0;
+        std::size_t count = 0;
+
+        void refill() {
+            input.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+            count = static_cast<std::size_t>(input.gcount()) / sizeof(Record);
+            position = 0;
+        }
+    };
+
+    // Visits every record in run order; among equal keys the earlier run
+    // comes first, which keeps the order of the file.
+    template <typename OnRecord>
+    static void mergeRuns(const std::vector<std::filesystem::path>& runs, bool reverse, const OnRecord& onRecord) {
+        std::vector<RunReader> readers{};
+        readers.reserve(runs.size());
+        for (const auto& run : runs) {
+            readers.emplace_back(run);
+        }
+
+        using Key = std::tuple<VertexId, VertexId, std::size_t>;
+        auto keyOf = [&](std::size_t run) {
+            const auto& record = readers[run].current();
+            return reverse ? Key{record.to, record.from, run} : Key{record.from, 0, run};
+        };
+
+        std::priority_queue<Key, std::vector<Key>, std::greater<>> heads{};
+        for (std::size_t run = 0; run < readers.size(); run++) {
+            if (!readers[run].done()) {
+                heads.push(keyOf(run));
+            }
+        }
+
+        while (!heads.empty()) {
+            auto run = std::get<2>(heads.top());
+            heads.pop();
+
+            onRecord(readers[run].current());
+            readers[run].advance();
+
+            if (!readers[run].done()) {
+                heads.push(keyOf(run));
+            }
+        }
+    }
+
+    void writeSections(
+        SnapshotWriter& writer,
+        const std::vector<std::filesystem::path>& runs,
+        const std::vector<std::uint64_t>& degrees,
+        SnapshotSection offsetsSection,
+        SnapshotSection neighborsSection,
+        SnapshotSection weightsSection
+    ) const {
+        bool reverse = offsetsSection == SnapshotSection::ReverseOffsets;
+
+        std::vector<std::uint64_t> offsets(degrees.empty() ? 0 : degrees.size() + 1, 0);
+        for (std::size_t vertex = 0; vertex < degrees.size(); vertex++) {
+            offsets[vertex + 1] = offsets[vertex] + degrees[vertex];
+        }
+        writer.write(offsetsSection, std::span<const std::uint64_t>(offsets));
+
+        writeMerged<VertexId>(writer, runs, reverse, neighborsSection, [reverse](const Record& record) {
+            return reverse ? record.from : record.to;
+        });
+
+        if constexpr (WEIGHTED) {
+            writeMerged<E>(writer, runs, reverse, weightsSection, [](const Record& record) {
+                return record.weight;
+            });
+        }
+    }
+
+    template <typename T, typename Field>
+    static void writeMerged(
+        SnapshotWriter& writer,
+        const std::vector<std::filesystem::path>& runs,
+        bool reverse,
+        SnapshotSection section,
+        const Field& field
+    ) {
+        std::vector<T> pending{};
+        pending.reserve(RUN_READ_RECORDS);
+
+        writer.beginSection(section);
+        mergeRuns(runs, reverse, [&](const Record& record) {
+            pending.push_back(field(record));
+
+            if (pending.size() == RUN_READ_RECORDS) {
+                writer.append(std::span<const T>(pending));
+                pending.clear();
+            }
+        });
+        writer.append(std::span<const T>(pending));
+        writer.endSection();
+    }
+};
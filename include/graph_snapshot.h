@@ -0,0 +1,381 @@
+#pragma once
+
+#include "csr_graph.h"
+#include "mapped_file.h"
+#include "vertex_interner.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+// A snapshot file is a fixed header followed by raw arrays, each starting on
+// a 64-byte boundary. Arrays are stored exactly as they sit in memory
+// (native byte order, 64-bit sizes), so loading one is a bounds check and a
+// pointer, and every process mapping the same file shares its pages.
+enum class SnapshotSection : std::uint32_t {
+    LabelCharacters,
+    LabelOffsets,
+    LabelHashes,
+    LabelSlots,
+    Offsets,
+    Neighbors,
+    Weights,
+    ReverseOffsets,
+    ReverseNeighbors,
+    ReverseWeights,
+    Count,
+};
+
+
+struct SnapshotExtent {
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+
+struct SnapshotHeader {
+    static constexpr std::array<char, 8> MAGIC{'C', 'S', 'R', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t weightSize;
+    // Label hashes are only meaningful to the std::hash that produced them,
+    // so a snapshot records one sample and refuses to load elsewhere.
+    std::uint64_t hashCheck;
+    std::uint64_t vertexCount;
+    std::array<SnapshotExtent, static_cast<std::size_t>(SnapshotSection::Count)> sections;
+
+    static std::uint64_t expectedHashCheck() {
+        return std::hash<std::string_view>{}("graph snapshot");
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+static_assert(sizeof(std::size_t) == sizeof(std::uint64_t), "snapshots store label offsets as 64-bit sizes");
+
+
+// Writes to a temporary file next to the target and renames it into place
+// on commit, so processes that still map the old snapshot keep valid pages.
+class SnapshotWriter {
+public:
+    SnapshotWriter(const std::string& path, std::uint64_t vertexCount, std::uint32_t weightSize)
+        : path(path), temporaryPath(path + ".partial"), output(temporaryPath, std::ios::binary | std::ios::trunc) {
+        if (!output) {
+            throw std::runtime_error("SnapshotWriter: cannot open " + temporaryPath);
+        }
+
+        header.magic = SnapshotHeader::MAGIC;
+        header.version = SnapshotHeader::VERSION;
+        header.weightSize = weightSize;
+        header.hashCheck = SnapshotHeader::expectedHashCheck();
+        header.vertexCount = vertexCount;
+
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    ~SnapshotWriter() {
+        if (!committed) {
+            output.close();
+            std::error_code ignored{};
+            std::filesystem::remove(temporaryPath, ignored);
+        }
+    }
+
+    template <typename T>
+    void write(SnapshotSection section, std::span<const T> values) {
+        beginSection(section);
+        append(values);
+        endSection();
+    }
+
+    // A section can also be streamed in pieces between beginSection and
+    // endSection, for arrays that never exist in memory as a whole.
+    void beginSection(SnapshotSection section) {
+        std::uint64_t position = static_cast<std::uint64_t>(output.tellp());
+        std::uint64_t aligned = (position + SnapshotHeader::ALIGNMENT - 1) / SnapshotHeader::ALIGNMENT * SnapshotHeader::ALIGNMENT;
+        std::array<char, SnapshotHeader::ALIGNMENT> padding{};
+
+        output.write(padding.data(), static_cast<std::streamsize>(aligned - position));
+
+        openSection = section;
+        header.sections[static_cast<std::size_t>(section)] = SnapshotExtent{aligned, 0};
+    }
+
+    template <typename T>
+    void append(std::span<const T> values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        output.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+        header.sections[static_cast<std::size_t>(openSection)].size += values.size_bytes();
+    }
+
+    void endSection() {
+        openSection = SnapshotSection::Count;
+    }
+
+    void writeLabels(const LabelTables& labels) {
+        write(SnapshotSection::LabelCharacters, labels.characters);
+        write(SnapshotSection::LabelOffsets, labels.labelOffsets);
+        write(SnapshotSection::LabelHashes, labels.hashes);
+        write(SnapshotSection::LabelSlots, labels.slots);
+    }
+
+    template <typename Graph>
+    void writeGraph(const Graph& graph, SnapshotSection offsets, SnapshotSection neighbors) {
+        write(offsets, graph.allOffsets());
+        write(neighbors, graph.allNeighbors());
+    }
+
+    void commit() {
+        output.seekp(0);
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.close();
+
+        if (!output) {
+            throw std::runtime_error("SnapshotWriter: cannot write " + temporaryPath);
+        }
+
+        std::filesystem::rename(temporaryPath, path);
+        committed = true;
+    }
+
+private:
+    std::string path;
+    std::string temporaryPath;
+    std::ofstream output;
+    SnapshotHeader header{};
+    SnapshotSection openSection = SnapshotSection::Count;
+    bool committed = false;
+};
+
+
+// Read-only mapping of a whole snapshot file. Only the header is validated
+// up front; array contents are trusted, so opening never touches them.
+class GraphSnapshot {
+public:
+    explicit GraphSnapshot(const std::string& path)
+        : file(path) {
+        if (file.size() < sizeof(SnapshotHeader)) {
+            throw std::runtime_error("GraphSnapshot: " + path + " is too short");
+        }
+
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (header.magic != SnapshotHeader::MAGIC || header.version != SnapshotHeader::VERSION) {
+            throw std::runtime_error("GraphSnapshot: " + path + " is not a version 1 snapshot");
+        }
+
+        if (header.hashCheck != SnapshotHeader::expectedHashCheck()) {
+            throw std::runtime_error("GraphSnapshot: " + path + " was written with an incompatible label hash");
+        }
+
+        for (const auto& extent : header.sections) {
+            if (extent.offset % SnapshotHeader::ALIGNMENT != 0 || extent.offset > file.size() || extent.size > file.size() - extent.offset) {
+                throw std::runtime_error("GraphSnapshot: " + path + " has a section outside of the file");
+            }
+        }
+    }
+
+    std::uint64_t vertexCount() const {
+        return header.vertexCount;
+    }
+
+    std::uint32_t weightSize() const {
+        return header.weightSize;
+    }
+
+    template <typename T>
+    std::span<const T> section(SnapshotSection section) const {
+        const auto& extent = header.sections[static_cast<std::size_t>(section)];
+
+        if (extent.size % sizeof(T) != 0) {
+            throw std::runtime_error("GraphSnapshot: section size does not match its element type");
+        }
+
+        return std::span<const T>(reinterpret_cast<const T*>(file.data() + extent.offset), extent.size / sizeof(T));
+    }
+
+private:
+    MappedFile file;
+    SnapshotHeader header{};
+};
+
+
+// CsrGraph over arrays inside a mapped snapshot. Copies share the mapping.
+class MappedCsrGraph {
+public:
+    using VertexId = CsrGraph::VertexId;
+
+    MappedCsrGraph() = default;
+
+    MappedCsrGraph(std::shared_ptr<const GraphSnapshot> snapshot, SnapshotSection offsetsSection, SnapshotSection neighborsSection)
+        : snapshot(std::move(snapshot)),
+          offsets(this->snapshot->section<std::uint64_t>(offsetsSection)),
+          neighbors(this->snapshot->section<VertexId>(neighborsSection)) {
+        bool empty = offsets.empty() && neighbors.empty() && this->snapshot->vertexCount() == 0;
+
+        if (!empty && (offsets.size() != this->snapshot->vertexCount() + 1 || offsets.back() != neighbors.size())) {
+            throw std::runtime_error("MappedCsrGraph: offsets do not match the neighbor array");
+        }
+    }
+
+    VertexId vertexCount() const {
+        return offsets.empty() ? 0 : static_cast<VertexId>(offsets.size() - 1);
+    }
+
+    std::size_t edgeCount() const {
+        return neighbors.size();
+    }
+
+    std::size_t firstEdgeOf(VertexId vertex) const {
+        return offsets[vertex];
+    }
+
+    std::size_t lastEdgeOf(VertexId vertex) const {
+        return offsets[vertex + 1];
+    }
+
+    std::span<const VertexId> neighborsOf(VertexId vertex) const {
+        return neighbors.subspan(firstEdgeOf(vertex), lastEdgeOf(vertex) - firstEdgeOf(vertex));
+    }
+
+    std::span<const std::uint64_t> allOffsets() const {
+        return offsets;
+    }
+
+    std::span<const VertexId> allNeighbors() const {
+        return neighbors;
+    }
+
+protected:
+    std::shared_ptr<const GraphSnapshot> snapshot{};
+    std::span<const std::uint64_t> offsets{};
+    std::span<const VertexId> neighbors{};
+};
+
+
+template <typename E>
+class MappedWeightedCsrGraph : public MappedCsrGraph {
+public:
+    MappedWeightedCsrGraph() = default;
+
+    MappedWeightedCsrGraph(
+        std::shared_ptr<const GraphSnapshot> snapshot,
+        SnapshotSection offsetsSection,
+        SnapshotSection neighborsSection,
+        SnapshotSection weightsSection
+    ) : MappedCsrGraph(std::move(snapshot), offsetsSection, neighborsSection) {
+        if (this->snapshot->weightSize() != sizeof(E)) {
+            throw std::runtime_error("MappedWeightedCsrGraph: snapshot weights have a different size");
+        }
+
+        weights = this->snapshot->template section<E>(weightsSection);
+
+        if (weights.size() != neighbors.size()) {
+            throw std::runtime_error("MappedWeightedCsrGraph: weights do not match the neighbor array");
+        }
+    }
+
+    std::span<const E> weightsOf(VertexId vertex) const {
+        return weights.subspan(firstEdgeOf(vertex), lastEdgeOf(vertex) - firstEdgeOf(vertex));
+    }
+
+    std::span<const E> allWeights() const {
+        return weights;
+    }
+
+    auto edgesOf(VertexId vertex) const {
+        return std::views::iota(firstEdgeOf(vertex), lastEdgeOf(vertex))
+            | std::views::transform([this, vertex](std::size_t edge) {
+                return WeightedEdge<E>{vertex, neighbors[edge], weights[edge], edge};
+            });
+    }
+
+    auto edges() const {
+        return std::views::iota(VertexId{0}, vertexCount())
+            | std::views::transform([this](VertexId vertex) {
+                return edgesOf(vertex);
+            })
+            | std::views::join;
+    }
+
+private:
+    std::span<const E> weights{};
+};
+
+
+// Graphs that PathFinder and BreadthFirstSearch open read-only from a
+// snapshot.
+template <typename Graph>
+concept MappedGraph = std::derived_from<Graph, MappedCsrGraph>;
+
+
+// Read-only string interner over the label tables of a mapped snapshot.
+class MappedVertexInterner {
+public:
+    using VertexId = CsrGraph::VertexId;
+
+    MappedVertexInterner() = default;
+
+    explicit MappedVertexInterner(std::shared_ptr<const GraphSnapshot> snapshot)
+        : snapshot(std::move(snapshot)) {
+        labels.characters = this->snapshot->section<char>(SnapshotSection::LabelCharacters);
+        labels.labelOffsets = this->snapshot->section<std::size_t>(SnapshotSection::LabelOffsets);
+        labels.hashes = this->snapshot->section<std::size_t>(SnapshotSection::LabelHashes);
+        labels.slots = this->snapshot->section<VertexId>(SnapshotSection::LabelSlots);
+
+        auto vertexCount = this->snapshot->vertexCount();
+        bool slotsValid = std::has_single_bit(labels.slots.size()) && labels.slots.size() > vertexCount;
+
+        if (labels.hashes.size() != vertexCount
+            || labels.labelOffsets.size() != vertexCount + 1
+            || labels.labelOffsets.back() != labels.characters.size()
+            || !slotsValid) {
+            throw std::runtime_error("MappedVertexInterner: label tables do not match the vertex count");
+        }
+    }
+
+    std::optional<VertexId> find(std::string_view label) const {
+        if (labels.slots.empty()) {
+            return std::nullopt;
+        }
+
+        return labels.find(label);
+    }
+
+    std::string_view labelOf(VertexId id) const {
+        return labels.labelOf(id);
+    }
+
+    VertexId size() const {
+        return static_cast<VertexId>(labels.hashes.size());
+    }
+
+    LabelTables tables() const {
+        return labels;
+    }
+
+private:
+    std::shared_ptr<const GraphSnapshot> snapshot{};
+    LabelTables labels{};
+};
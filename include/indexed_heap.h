@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+
+// Min-heap over ids in [0, capacity) with decrease-key. Every id is in the
+// heap at most once, so there are no stale entries to skip on pop.
+template <typename P, std::size_t ARITY = 4>
+class IndexedDaryHeap {
+public:
+    using Id = std::uint32_t;
+
+    static_assert(ARITY >= 2, "IndexedDaryHeap needs at least two children per node");
+
+    IndexedDaryHeap(std::size_t capacity = 0)
+        : priorities(capacity), positions(capacity, NOT_IN_HEAP) {}
+
+    void resize(std::size_t capacity) {
+        clear();
+        priorities.resize(capacity);
+        positions.assign(capacity, NOT_IN_HEAP);
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    std::size_t size() const {
+        return heap.size();
+    }
+
+    bool contains(Id id) const {
+        return positions[id] != NOT_IN_HEAP;
+    }
+
+    const P& priorityOf(Id id) const {
+        return priorities[id];
+    }
+
+    Id top() const {
+        return heap.front();
+    }
+
+    void push(Id id, const P& priority) {
+        if (contains(id)) {
+            throw std::logic_error("IndexedDaryHeap: id is already in the heap");
+        }
+
+        priorities[id] = priority;
+        positions[id] = heap.size();
+        heap.push_back(id);
+        siftUp(heap.size() - 1);
+    }
+
+    void decrease(Id id, const P& priority) {
+        if (priorities[id] < priority) {
+            throw std::logic_error("IndexedDaryHeap: decrease would increase priority");
+        }
+
+        priorities[id] = priority;
+        siftUp(positions[id]);
+    }
+
+    void pushOrDecrease(Id id, const P& priority) {
+        if (contains(id)) {
+            decrease(id, priority);
+        } else {
+            push(id, priority);
+        }
+    }
+
+    Id pop() {
+        Id id = heap.front();
+        positions[id] = NOT_IN_HEAP;
+
+        Id last = heap.back();
+        heap.pop_back();
+
+        if (!heap.empty()) {
+            heap[0] = last;
+            positions[last] = 0;
+            siftDown(0);
+        }
+
+        return id;
+    }
+
+    void clear() {
+        for (auto id : heap) {
+            positions[id] = NOT_IN_HEAP;
+        }
+
+        heap.clear();
+    }
+
+private:
+    static constexpr std::size_t NOT_IN_HEAP = std::numeric_limits<std::size_t>::max();
+
+    std::vector<Id> heap{};
+    std::vector<P> priorities{};
+    std::vector<std::size_t> positions{};
+
+    void place(std::size_t position, Id id) {
+        heap[position] = id;
+        positions[id] = position;
+    }
+
+    void siftUp(std::size_t position) {
+        Id id = heap[position];
+
+        while (position > 0) {
+            std::size_t parent = (position - 1) / ARITY;
+
+            if (!(priorities[id] < priorities[heap[parent]])) {
+                break;
+            }
+
+            place(position, heap[parent]);
+            position = parent;
+        }
+
+        place(position, id);
+    }
+
+    void siftDown(std::size_t position) {
+        Id id = heap[position];
+
+        while (true) {
+            std::size_t firstChild = position * ARITY + 1;
+            if (firstChild >= heap.size()) {
+                break;
+            }
+
+            std::size_t lastChild = std::min(firstChild + ARITY, heap.size());
+            std::size_t best = firstChild;
+
+            for (std::size_t child = firstChild + 1; child < lastChild; child++) {
+                if (priorities[heap[child]] < priorities[heap[best]]) {
+                    best = child;
+                }
+            }
+
+            if (!(priorities[heap[best]] < priorities[id])) {
+                break;
+            }
+
+            place(position, heap[best]);
+            position = best;
+        }
+
+        place(position, id);
+    }
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// Read-only mapping of a whole file. Pages are loaded on first touch and
+// shared with every other process that maps the same file.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        map(path);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        unmap();
+    }
+
+    const char* data() const {
+        return bytes;
+    }
+
+    std::size_t size() const {
+        return length;
+    }
+
+    std::string_view text() const {
+        return std::string_view(bytes, length);
+    }
+
+private:
+    const char* bytes = nullptr;
+    std::size_t length = 0;
+
+#ifdef _WIN32
+    void map(const std::string& path) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "MappedFile: cannot open " + path);
+        }
+
+        LARGE_INTEGER size{};
+        GetFileSizeEx(file, &size);
+        length = static_cast<std::size_t>(size.QuadPart);
+
+        HANDLE mapping = length == 0 ? nullptr : CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+
+        if (mapping != nullptr) {
+            bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+        }
+
+        if (bytes == nullptr && length != 0) {
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "MappedFile: cannot map " + path);
+        }
+    }
+
+    void unmap() {
+        if (bytes != nullptr) {
+            UnmapViewOfFile(bytes);
+            bytes = nullptr;
+        }
+    }
+#else
+    void map(const std::string& path) {
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            throw std::system_error(errno, std::generic_category(), "MappedFile: cannot open " + path);
+        }
+
+        struct stat status{};
+        ::fstat(file, &status);
+        length = static_cast<std::size_t>(status.st_size);
+
+        void* mapped = length == 0 ? nullptr : ::mmap(nullptr, length, PROT_READ, MAP_SHARED, file, 0);
+        int error = errno;
+        ::close(file);
+
+        if (mapped == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(), "MappedFile: cannot map " + path);
+        }
+
+        bytes = static_cast<const char*>(mapped);
+    }
+
+    void unmap() {
+        if (bytes != nullptr) {
+            ::munmap(const_cast<char*>(bytes), length);
+            bytes = nullptr;
+        }
+    }
+#endif
+};
@@ -0,0 +1,414 @@
+#pragma once
+
+#include "mapped_file.h"
+#include "simd_level.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+
+namespace number_kernels {
+
+inline bool isWhitespace(char character) {
+    return character == ' ' || (character >= '\t' && character <= '\r');
+}
+
+
+// Value of the leading decimal digits in eight little-endian bytes, and how
+// many there are. Every byte is classified and converted at once, so a
+// number costs a few multiplies instead of a loop over its characters.
+inline std::uint64_t eightDigits(const char* cursor, std::size_t& length) {
+    std::uint64_t bytes{};
+    std::memcpy(&bytes, cursor, sizeof(bytes));
+
+    auto values = bytes ^ 0x3030303030303030u;
+    auto nonDigits = ((values + 0x7676767676767676u) | values) & 0x8080808080808080u;
+    length = static_cast<std::size_t>(std::countr_zero(nonDigits)) / 8;
+
+    values = (values << ((64 - 8 * length) & 63)) & (std::uint64_t{0} - (length != 0));
+    values = values * 10 + (values >> 8);
+    return (
+        (values & 0x000000FF000000FFu) * (100 + (1000000ull << 32))
+        + ((values >> 16) & 0x000000FF000000FFu) * (1 + (10000ull << 32))
+    ) >> 32;
+}
+
+
+// Parses the number starting at cursor. Returns the end of the number, or
+// nullptr when there is none or it does not fit in T.
+template <std::integral T>
+const char* parseToken(const char* cursor, const char* end, std::vector<T>& numbers) {
+    if (*cursor == '+' && cursor + 1 != end && *(cursor + 1) != '-') {
+        cursor++;
+    }
+
+    // Far enough from the end for the eight-byte load after a sign.
+    if constexpr (std::endian::native == std::endian::little && sizeof(T) <= sizeof(std::int64_t)) {
+        if (end - cursor >= 9) {
+            bool negative = std::is_signed_v<T> && *cursor == '-';
+            const char* digits = cursor + negative;
+
+            std::size_t length = 0;
+            std::uint64_t magnitude = eightDigits(digits, length);
+
+            for (; length >= 8 && digits + length != end && length < 20 && *(digits + length) >= '0' && *(digits + length) <= '9'; length++) {
+                magnitude = magnitude * 10 + static_cast<std::uint64_t>(*(digits + length) - '0');
+            }
+
+            using Unsigned = std::make_unsigned_t<T>;
+            std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<Unsigned>::max()) >> std::is_signed_v<T>;
+
+            bool fits = length > 0 && length < 19 && magnitude <= limit + negative;
+            if (fits) {
+                numbers.push_back(static_cast<T>(negative ? Unsigned{0} - static_cast<Unsigned>(magnitude) : static_cast<Unsigned>(magnitude)));
+                return digits + length;
+            }
+        }
+    }
+
+    T value{};
+    auto [next, error] = std::from_chars(cursor, end, value);
+
+    if (error != std::errc{}) {
+        return nullptr;
+    }
+
+    numbers.push_back(value);
+    return next;
+}
+
+
+// Stops at the first token that is not a number or is glued to one, after
+// keeping any number in front of it. For whitespace-separated input that is
+// where istream_iterator stops too. Unlike istream_iterator, a sign right
+// after digits does not start a new number: "12-5" stops after the 12.
+template <std::integral T>
+const char* parseScalar(const char* cursor, const char* end, std::vector<T>& numbers) {
+    while (cursor != end) {
+        if (isWhitespace(*cursor)) {
+            cursor++;
+            continue;
+        }
+
+        auto next = parseToken(cursor, end, numbers);
+        if (next == nullptr) {
+            return cursor;
+        }
+
+        if (next != end && !isWhitespace(*next)) {
+            return next;
+        }
+
+        cursor = next;
+    }
+
+    return end;
+}
+
+
+#ifdef SIMD_LEVEL_X86
+
+struct Avx2 {
+    static constexpr std::size_t WIDTH = 32;
+};
+
+struct Sse41 {
+    static constexpr std::size_t WIDTH = 16;
+};
+
+// Bit i is set when bytes[i] is a space or one of '\t' ... '\r'.
+__attribute__((target("avx2")))
+inline std::uint64_t whitespaceMask(const char* bytes, Avx2) {
+    auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+    auto space = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+    auto shifted = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+    auto control = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8('\r' - '\t')), shifted);
+
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(space, control)));
+}
+
+__attribute__((target("sse4.1")))
+inline std::uint64_t whitespaceMask(const char* bytes, Sse41) {
+    auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    auto space = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+    auto shifted = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+    auto control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_or_si128(space, control)));
+}
+
+
+// Classifies a block of bytes at a time and only parses where a token
+// starts, i.e. a non-whitespace byte follows a whitespace byte. This skips
+// long whitespace runs such as column padding in one step; on densely packed
+// numbers the scalar loop is faster.
+template <typename Tag, std::integral T>
+const char* parseBlocks(const char* begin, const char* end, std::vector<T>& numbers) {
+    constexpr std::uint64_t FULL = Tag::WIDTH == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << Tag::WIDTH) - 1;
+
+    const char* parsed = begin;
+    const char* block = begin;
+    std::uint64_t previousWhitespace = 1;
+
+    for (; static_cast<std::size_t>(end - block) >= Tag::WIDTH; block += Tag::WIDTH) {
+        auto whitespace = whitespaceMask(block, Tag{});
+        auto starts = ~whitespace & ((whitespace << 1) | previousWhitespace) & FULL;
+        previousWhitespace = whitespace >> (Tag::WIDTH - 1);
+
+        for (; starts != 0; starts &= starts - 1) {
+            auto start = block + std::countr_zero(starts);
+
+            auto next = parseToken(start, end, numbers);
+            if (next == nullptr) {
+                return start;
+            }
+
+            parsed = next;
+            if (parsed != end && !isWhitespace(*parsed)) {
+                return parsed;
+            }
+        }
+    }
+
+    return parseScalar(parsed > block ? parsed : block, end, numbers);
+}
+
+#endif
+
+}
+
+
+// Appends every whitespace-separated integer in text to numbers and returns
+// how many characters were consumed: all of them, or up to the first token
+// that is not a number. As long as numbers are separated by whitespace,
+// istream_iterator stops at the same point. Numbers glued together by a
+// sign, as in "12-5", are the exception: this stops after the 12, where
+// istream_iterator goes on to read -5. Pass a SIMD level to scan
+// whitespace in vector blocks, which pays off for column-aligned input.
+template <std::integral T>
+std::size_t parseNumbers(std::string_view text, std::vector<T>& numbers, SimdLevel level = SimdLevel::Scalar) {
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    const char* stop = nullptr;
+
+    switch (level) {
+#ifdef SIMD_LEVEL_X86
+        case SimdLevel::Avx2:
+            stop = number_kernels::parseBlocks<number_kernels::Avx2>(begin, end, numbers);
+            break;
+        case SimdLevel::Sse41:
+            stop = number_kernels::parseBlocks<number_kernels::Sse41>(begin, end, numbers);
+            break;
+#endif
+        default:
+            stop = number_kernels::parseScalar(begin, end, numbers);
+            break;
+    }
+
+    return static_cast<std::size_t>(stop - begin);
+}
+
+
+// Reads one line and replaces the contents of numbers with the integers on
+// it. The line goes through buffer a chunk at a time instead of being copied
+// whole, so even a very long line is parsed while it is still in cache. A
+// token cut off at the end of a chunk is moved to the front of the buffer
+// and finished by the next one. Both keep their capacity, so reusing them
+// across calls avoids allocating.
+template <std::integral T>
+void readNumbers(std::istream& input, std::vector<T>& numbers, std::string& buffer) {
+    constexpr std::size_t CHUNK_SIZE = 1 << 16;
+
+    numbers.clear();
+    buffer.resize(std::max(buffer.size(), CHUNK_SIZE));
+
+    std::size_t carried = 0;
+    bool extractedAny = false;
+    bool stopped = false;
+
+    while (true) {
+        input.getline(buffer.data() + carried, static_cast<std::streamsize>(buffer.size() - carried));
+
+        auto extracted = static_cast<std::size_t>(input.gcount());
+        extractedAny |= extracted != 0;
+
+        // getline fails without reaching the end of the stream only when the
+        // chunk filled up before the end of the line.
+        if (!input.fail() || input.eof()) {
+            auto length = carried + extracted - !input.eof();
+            if (!stopped) {
+                parseNumbers(std::string_view(buffer.data(), length), numbers);
+            }
+
+            // Like std::getline, only fail when nothing was extracted at all.
+            if (extractedAny && input.eof()) {
+                input.clear(std::ios::eofbit);
+            }
+            return;
+        }
+
+        input.clear();
+
+        // Past the first bad token the rest of the line is only skipped.
+        if (stopped) {
+            carried = 0;
+            continue;
+        }
+
+        auto length = buffer.size() - 1;
+        auto split = length;
+        while (split != 0 && !number_kernels::isWhitespace(buffer[split - 1])) {
+            split--;
+        }
+
+        if (split == 0) {
+            buffer.resize(buffer.size() * 2);
+            carried = length;
+            continue;
+        }
+
+        stopped = parseNumbers(std::string_view(buffer.data(), split), numbers) != split;
+
+        std::memmove(buffer.data(), buffer.data() + split, length - split);
+        carried = length - split;
+    }
+}
+
+template <std::integral T>
+void readNumbers(std::istream& input, std::vector<T>& numbers) {
+    std::string buffer{};
+    readNumbers(input, numbers, buffer);
+}
+
+
+// Splits text at whitespace into a few chunks per thread, parses them on the
+// pool and appends the results in their original order. Like parseNumbers,
+// stops at the first token that is not a number and returns how many
+// characters were consumed.
+template <std::integral T>
+std::size_t parseNumbersInParallel(
+    std::string_view text,
+    std::vector<T>& numbers,
+    ThreadPool& pool,
+    SimdLevel level = SimdLevel::Scalar
+) {
+    constexpr std::size_t TASKS_PER_THREAD = 4;
+    constexpr std::size_t MINIMUM_CHUNK_SIZE = 1 << 16;
+
+    std::size_t chunkCount = std::clamp<std::size_t>(
+        text.size() / MINIMUM_CHUNK_SIZE,
+        1,
+        pool.threadCount() * TASKS_PER_THREAD
+    );
+
+    std::vector<std::size_t> bounds(chunkCount + 1, text.size());
+    bounds[0] = 0;
+
+    for (std::size_t chunk = 1; chunk < chunkCount; chunk++) {
+        auto bound = std::max(text.size() / chunkCount * chunk, bounds[chunk - 1]);
+
+        while (bound < text.size() && !number_kernels::isWhitespace(text[bound])) {
+            bound++;
+        }
+
+        bounds[chunk] = bound;
+    }
+
+    std::vector<std::vector<T>> parts(chunkCount);
+    std::vector<std::size_t> consumed(chunkCount);
+
+    pool.run(chunkCount, [&](std::size_t chunk) {
+        auto piece = text.substr(bounds[chunk], bounds[chunk + 1] - bounds[chunk]);
+        consumed[chunk] = parseNumbers(piece, parts[chunk], level);
+    });
+
+    // Chunks after one that stopped early are dropped, as a serial parse
+    // would never have reached them.
+    std::vector<std::size_t> destinations(chunkCount + 1, numbers.size());
+    std::size_t kept = 0;
+
+    while (kept < chunkCount) {
+        destinations[kept + 1] = destinations[kept] + parts[kept].size();
+        kept++;
+
+        if (bounds[kept - 1] + consumed[kept - 1] != bounds[kept]) {
+            break;
+        }
+    }
+
+    numbers.resize(destinations[kept]);
+
+    pool.run(kept, [&](std::size_t chunk) {
+        std::copy(parts[chunk].begin(), parts[chunk].end(), numbers.begin() + destinations[chunk]);
+    });
+
+    return bounds[kept - 1] + consumed[kept - 1];
+}
+
+
+// Parses a whole file of whitespace-separated integers through a read-only
+// mapping, so the text is never copied.
+template <std::integral T>
+std::vector<T> readNumberFile(const std::string& path, ThreadPool& pool, SimdLevel level = SimdLevel::Scalar) {
+    MappedFile file{path};
+    std::vector<T> numbers{};
+
+    parseNumbersInParallel(file.text(), numbers, pool, level);
+    return numbers;
+}
+
+
+// Parses everything left in the stream, a block at a time. A number cut by
+// the end of a block is carried into the next one, so memory besides the
+// result stays at about one block.
+template <std::integral T>
+void readNumbersInParallel(
+    std::istream& input,
+    std::vector<T>& numbers,
+    ThreadPool& pool,
+    std::size_t blockSize = std::size_t{64} << 20,
+    SimdLevel level = SimdLevel::Scalar
+) {
+    std::string block{};
+    std::size_t carried = 0;
+
+    while (true) {
+        block.resize(carried + blockSize);
+        input.read(block.data() + carried, static_cast<std::streamsize>(blockSize));
+        block.resize(carried + static_cast<std::size_t>(input.gcount()));
+
+        bool last = !input;
+        auto usable = block.size();
+
+        if (!last) {
+            while (usable > carried && !number_kernels::isWhitespace(block[usable - 1])) {
+                usable--;
+            }
+
+            if (usable == carried) {
+                carried = block.size();
+                continue;
+            }
+        }
+
+        auto text = std::string_view(block).substr(0, usable);
+        if (parseNumbersInParallel(text, numbers, pool, level) != usable || last) {
+            return;
+        }
+
+        carried = block.size() - usable;
+        std::copy(block.begin() + usable, block.end(), block.begin());
+    }
+}
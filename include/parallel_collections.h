@@ -0,0 +1,450 @@
+#pragma once
+
+#include "simd_level.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+
+namespace collection_kernels {
+
+inline std::size_t maximumChunks(const ThreadPool& pool) {
+    constexpr std::size_t TASKS_PER_THREAD = 4;
+    return pool.threadCount() * TASKS_PER_THREAD;
+}
+
+
+// Splits count elements into at most maximumChunks(pool) contiguous chunks
+// and calls chunkTask(chunk, begin, end) for each of them on the pool.
+template <typename ChunkTask>
+std::size_t forEachChunk(std::size_t count, ThreadPool& pool, const ChunkTask& chunkTask) {
+    constexpr std::size_t MINIMUM_CHUNK_SIZE = 1 << 15;
+
+    std::size_t chunkCount = std::clamp<std::size_t>(count / MINIMUM_CHUNK_SIZE, 1, maximumChunks(pool));
+
+    pool.run(chunkCount, [&](std::size_t chunk) {
+        chunkTask(chunk, count / chunkCount * chunk, chunk + 1 == chunkCount ? count : count / chunkCount * (chunk + 1));
+    });
+
+    return chunkCount;
+}
+
+
+template <typename T>
+void addOneScalar(T* values, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+        values[i] += 1;
+    }
+}
+
+template <typename Sum, typename T>
+Sum sumScalar(const T* values, std::size_t begin, std::size_t end) {
+    Sum total{};
+    for (std::size_t i = begin; i < end; i++) {
+        total += values[i];
+    }
+    return total;
+}
+
+inline std::size_t countOddScalar(const std::int32_t* values, std::size_t begin, std::size_t end) {
+    std::size_t count = 0;
+    for (std::size_t i = begin; i < end; i++) {
+        count += values[i] & 1;
+    }
+    return count;
+}
+
+inline std::int32_t* copyOddScalar(const std::int32_t* values, std::size_t begin, std::size_t end, std::int32_t* output) {
+    for (std::size_t i = begin; i < end; i++) {
+        if (values[i] & 1) {
+            *output++ = values[i];
+        }
+    }
+    return output;
+}
+
+
+#ifdef SIMD_LEVEL_X86
+
+struct Avx2 {};
+struct Sse41 {};
+
+// Row m lists the set bits of m in order, padded with zeros: the lane
+// indices that pack the selected lanes of a block to its front.
+template <std::size_t LANES>
+constexpr auto packingLanes() {
+    std::array<std::array<std::uint8_t, LANES>, std::size_t{1} << LANES> rows{};
+
+    for (std::size_t mask = 0; mask < rows.size(); mask++) {
+        std::size_t packed = 0;
+        for (std::uint8_t lane = 0; lane < LANES; lane++) {
+            if ((mask >> lane) & 1) {
+                rows[mask][packed++] = lane;
+            }
+        }
+    }
+
+    return rows;
+}
+
+inline constexpr auto PACK_8_LANES = packingLanes<8>();
+inline constexpr auto PACK_4_LANES = packingLanes<4>();
+
+
+__attribute__((target("avx2")))
+inline void addOne(std::int32_t* values, std::size_t begin, std::size_t end, Avx2) {
+    auto one = _mm256_set1_epi32(1);
+
+    for (; begin + 8 <= end; begin += 8) {
+        auto block = reinterpret_cast<__m256i*>(values + begin);
+        _mm256_storeu_si256(block, _mm256_add_epi32(_mm256_loadu_si256(block), one));
+    }
+
+    addOneScalar(values, begin, end);
+}
+
+__attribute__((target("avx2")))
+inline void addOne(float* values, std::size_t begin, std::size_t end, Avx2) {
+    auto one = _mm256_set1_ps(1.0f);
+
+    for (; begin + 8 <= end; begin += 8) {
+        _mm256_storeu_ps(values + begin, _mm256_add_ps(_mm256_loadu_ps(values + begin), one));
+    }
+
+    addOneScalar(values, begin, end);
+}
+
+__attribute__((target("sse4.1")))
+inline void addOne(std::int32_t* values, std::size_t begin, std::size_t end, Sse41) {
+    auto one = _mm_set1_epi32(1);
+
+    for (; begin + 4 <= end; begin += 4) {
+        auto block = reinterpret_cast<__m128i*>(values + begin);
+        _mm_storeu_si128(block, _mm_add_epi32(_mm_loadu_si128(block), one));
+    }
+
+    addOneScalar(values, begin, end);
+}
+
+__attribute__((target("sse4.1")))
+inline void addOne(float* values, std::size_t begin, std::size_t end, Sse41) {
+    auto one = _mm_set1_ps(1.0f);
+
+    for (; begin + 4 <= end; begin += 4) {
+        _mm_storeu_ps(values + begin, _mm_add_ps(_mm_loadu_ps(values + begin), one));
+    }
+
+    addOneScalar(values, begin, end);
+}
+
+
+// Ints are widened to 64-bit lanes and floats to doubles before adding, so
+// the vector sums overflow and round no earlier than the scalar ones.
+__attribute__((target("avx2")))
+inline std::int64_t sum(const std::int32_t* values, std::size_t begin, std::size_t end, Avx2) {
+    auto low = _mm256_setzero_si256();
+    auto high = _mm256_setzero_si256();
+
+    for (; begin + 8 <= end; begin += 8) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + begin));
+        low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(block)));
+        high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(block, 1)));
+    }
+
+    alignas(32) std::array<std::int64_t, 4> lanes{};
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes.data()), _mm256_add_epi64(low, high));
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumScalar<std::int64_t>(values, begin, end);
+}
+
+__attribute__((target("avx2")))
+inline double sum(const float* values, std::size_t begin, std::size_t end, Avx2) {
+    auto low = _mm256_setzero_pd();
+    auto high = _mm256_setzero_pd();
+
+    for (; begin + 8 <= end; begin += 8) {
+        auto block = _mm256_loadu_ps(values + begin);
+        low = _mm256_add_pd(low, _mm256_cvtps_pd(_mm256_castps256_ps128(block)));
+        high = _mm256_add_pd(high, _mm256_cvtps_pd(_mm256_extractf128_ps(block, 1)));
+    }
+
+    alignas(32) std::array<double, 4> lanes{};
+    _mm256_store_pd(lanes.data(), _mm256_add_pd(low, high));
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumScalar<double>(values, begin, end);
+}
+
+__attribute__((target("sse4.1")))
+inline std::int64_t sum(const std::int32_t* values, std::size_t begin, std::size_t end, Sse41) {
+    auto low = _mm_setzero_si128();
+    auto high = _mm_setzero_si128();
+
+    for (; begin + 4 <= end; begin += 4) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + begin));
+        low = _mm_add_epi64(low, _mm_cvtepi32_epi64(block));
+        high = _mm_add_epi64(high, _mm_cvtepi32_epi64(_mm_unpackhi_epi64(block, block)));
+    }
+
+    alignas(16) std::array<std::int64_t, 2> lanes{};
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes.data()), _mm_add_epi64(low, high));
+
+    return lanes[0] + lanes[1] + sumScalar<std::int64_t>(values, begin, end);
+}
+
+__attribute__((target("sse4.1")))
+inline double sum(const float* values, std::size_t begin, std::size_t end, Sse41) {
+    auto low = _mm_setzero_pd();
+    auto high = _mm_setzero_pd();
+
+    for (; begin + 4 <= end; begin += 4) {
+        auto block = _mm_loadu_ps(values + begin);
+        low = _mm_add_pd(low, _mm_cvtps_pd(block));
+        high = _mm_add_pd(high, _mm_cvtps_pd(_mm_movehl_ps(block, block)));
+    }
+
+    alignas(16) std::array<double, 2> lanes{};
+    _mm_store_pd(lanes.data(), _mm_add_pd(low, high));
+
+    return lanes[0] + lanes[1] + sumScalar<double>(values, begin, end);
+}
+
+
+// The low bit of every lane shifted into its sign bit, one bit per lane.
+__attribute__((target("avx2")))
+inline unsigned oddLanes(__m256i block, Avx2) {
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(block, 31))));
+}
+
+__attribute__((target("sse4.1")))
+inline unsigned oddLanes(__m128i block, Sse41) {
+    return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_slli_epi32(block, 31))));
+}
+
+__attribute__((target("avx2")))
+inline std::size_t countOdd(const std::int32_t* values, std::size_t begin, std::size_t end, Avx2) {
+    std::size_t count = 0;
+
+    for (; begin + 8 <= end; begin += 8) {
+        count += std::popcount(oddLanes(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + begin)), Avx2{}));
+    }
+
+    return count + countOddScalar(values, begin, end);
+}
+
+__attribute__((target("sse4.1")))
+inline std::size_t countOdd(const std::int32_t* values, std::size_t begin, std::size_t end, Sse41) {
+    std::size_t count = 0;
+
+    for (; begin + 4 <= end; begin += 4) {
+        count += std::popcount(oddLanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + begin)), Sse41{}));
+    }
+
+    return count + countOddScalar(values, begin, end);
+}
+
+
+// Packs the odd lanes of each block to the front with one permute and
+// stores the whole block; the next store overwrites the unused tail. Blocks
+// stop while a full store would pass outputEnd, so chunks can fill
+// neighbouring ranges of one output at the same time.
+__attribute__((target("avx2")))
+inline std::int32_t* copyOdd(const std::int32_t* values, std::size_t begin, std::size_t end, std::int32_t* output, const std::int32_t* outputEnd, Avx2) {
+    for (; begin + 8 <= end && output + 8 <= outputEnd; begin += 8) {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + begin));
+        auto odd = oddLanes(block, Avx2{});
+        auto lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(PACK_8_LANES[odd].data())));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), _mm256_permutevar8x32_epi32(block, lanes));
+        output += std::popcount(odd);
+    }
+
+    return copyOddScalar(values, begin, end, output);
+}
+
+__attribute__((target("sse4.1")))
+inline std::int32_t* copyOdd(const std::int32_t* values, std::size_t begin, std::size_t end, std::int32_t* output, const std::int32_t* outputEnd, Sse41) {
+    for (; begin + 4 <= end && output + 4 <= outputEnd; begin += 4) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + begin));
+        auto odd = oddLanes(block, Sse41{});
+
+        // Lane indices become byte indices for the byte shuffle.
+        std::uint32_t lanes{};
+        std::memcpy(&lanes, PACK_4_LANES[odd].data(), sizeof(lanes));
+        auto bytes = _mm_add_epi8(
+            _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(static_cast<int>(lanes))), _mm_set1_epi32(0x04040404)),
+            _mm_set1_epi32(0x03020100)
+        );
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_shuffle_epi8(block, bytes));
+        output += std::popcount(odd);
+    }
+
+    return copyOddScalar(values, begin, end, output);
+}
+
+#endif
+
+
+template <typename T>
+void addOne(T* values, std::size_t begin, std::size_t end, SimdLevel level) {
+    switch (level) {
+#ifdef SIMD_LEVEL_X86
+        case SimdLevel::Avx2:
+            return addOne(values, begin, end, Avx2{});
+        case SimdLevel::Sse41:
+            return addOne(values, begin, end, Sse41{});
+#endif
+        default:
+            return addOneScalar(values, begin, end);
+    }
+}
+
+template <typename Sum, typename T>
+Sum sum(const T* values, std::size_t begin, std::size_t end, SimdLevel level) {
+    switch (level) {
+#ifdef SIMD_LEVEL_X86
+        case SimdLevel::Avx2:
+            return sum(values, begin, end, Avx2{});
+        case SimdLevel::Sse41:
+            return sum(values, begin, end, Sse41{});
+#endif
+        default:
+            return sumScalar<Sum>(values, begin, end);
+    }
+}
+
+inline std::size_t countOdd(const std::int32_t* values, std::size_t begin, std::size_t end, SimdLevel level) {
+    switch (level) {
+#ifdef SIMD_LEVEL_X86
+        case SimdLevel::Avx2:
+            return countOdd(values, begin, end, Avx2{});
+        case SimdLevel::Sse41:
+            return countOdd(values, begin, end, Sse41{});
+#endif
+        default:
+            return countOddScalar(values, begin, end);
+    }
+}
+
+inline std::int32_t* copyOdd(const std::int32_t* values, std::size_t begin, std::size_t end, std::int32_t* output, const std::int32_t* outputEnd, SimdLevel level) {
+    switch (level) {
+#ifdef SIMD_LEVEL_X86
+        case SimdLevel::Avx2:
+            return copyOdd(values, begin, end, output, outputEnd, Avx2{});
+        case SimdLevel::Sse41:
+            return copyOdd(values, begin, end, output, outputEnd, Sse41{});
+#endif
+        default:
+            (void)outputEnd;
+            return copyOddScalar(values, begin, end, output);
+    }
+}
+
+}
+
+
+// The map / reduce / filter shapes of std::transform, std::reduce and
+// std::copy_if, split into chunks across a ThreadPool. Like the standard
+// parallel algorithms, reduce may combine elements in any order, so op
+// must be associative and commutative.
+template <typename T, typename U, typename Function>
+void transformInParallel(std::span<const T> input, std::span<U> output, const Function& function, ThreadPool& pool) {
+    collection_kernels::forEachChunk(input.size(), pool, [&](std::size_t, std::size_t begin, std::size_t end) {
+        std::transform(input.begin() + begin, input.begin() + end, output.begin() + begin, function);
+    });
+}
+
+
+template <typename T, typename R, typename Operation>
+R reduceInParallel(std::span<const T> values, R initial, const Operation& operation, ThreadPool& pool) {
+    if (values.empty()) {
+        return initial;
+    }
+
+    std::vector<R> partials(collection_kernels::maximumChunks(pool), R{});
+
+    auto chunkCount = collection_kernels::forEachChunk(values.size(), pool, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        partials[chunk] = std::reduce(values.begin() + begin + 1, values.begin() + end, R(values[begin]), operation);
+    });
+
+    return std::reduce(partials.begin(), partials.begin() + chunkCount, initial, operation);
+}
+
+
+template <typename T, typename Predicate>
+std::vector<T> copyIfInParallel(std::span<const T> values, const Predicate& predicate, ThreadPool& pool) {
+    std::vector<std::vector<T>> parts(collection_kernels::maximumChunks(pool));
+
+    auto chunkCount = collection_kernels::forEachChunk(values.size(), pool, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        std::copy_if(values.begin() + begin, values.begin() + end, std::back_inserter(parts[chunk]), predicate);
+    });
+
+    std::vector<std::size_t> offsets(chunkCount + 1, 0);
+    for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+        offsets[chunk + 1] = offsets[chunk] + parts[chunk].size();
+    }
+
+    std::vector<T> kept(offsets.back());
+    pool.run(chunkCount, [&](std::size_t chunk) {
+        std::copy(parts[chunk].begin(), parts[chunk].end(), kept.begin() + offsets[chunk]);
+    });
+
+    return kept;
+}
+
+
+// Hand-vectorized versions of the pipelines in tests/collections.cpp for
+// int and float columns: add one to every element, sum, and keep the odd
+// ints.
+template <typename T>
+    requires std::same_as<T, std::int32_t> || std::same_as<T, float>
+void addOneInParallel(std::span<T> values, ThreadPool& pool, SimdLevel level = detectedSimdLevel()) {
+    collection_kernels::forEachChunk(values.size(), pool, [&](std::size_t, std::size_t begin, std::size_t end) {
+        collection_kernels::addOne(values.data(), begin, end, level);
+    });
+}
+
+
+// Ints add up as 64-bit integers and floats as doubles.
+template <typename T>
+    requires std::same_as<T, std::int32_t> || std::same_as<T, float>
+auto sumInParallel(std::span<const T> values, ThreadPool& pool, SimdLevel level = detectedSimdLevel()) {
+    using Sum = std::conditional_t<std::same_as<T, float>, double, std::int64_t>;
+    std::vector<Sum> partials(collection_kernels::maximumChunks(pool), Sum{});
+
+    auto chunkCount = collection_kernels::forEachChunk(values.size(), pool, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        partials[chunk] = collection_kernels::sum<Sum>(values.data(), begin, end, level);
+    });
+
+    return std::accumulate(partials.begin(), partials.begin() + chunkCount, Sum{});
+}
+
+
+// Counts the odd values of each chunk first, so every chunk can then write
+// straight to its own range of the result.
+inline std::vector<std::int32_t> copyOddInParallel(std::span<const std::int32_t> values, ThreadPool& pool, SimdLevel level = detectedSimdLevel()) {
+    std::vector<std::size_t> offsets(collection_kernels::maximumChunks(pool) + 1, 0);
+
+    auto chunkCount = collection_kernels::forEachChunk(values.size(), pool, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        offsets[chunk + 1] = collection_kernels::countOdd(values.data(), begin, end, level);
+    });
+
+    std::partial_sum(offsets.begin(), offsets.begin() + chunkCount + 1, offsets.begin());
+    std::vector<std::int32_t> odd(offsets[chunkCount]);
+
+    collection_kernels::forEachChunk(values.size(), pool, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        collection_kernels::copyOdd(values.data(), begin, end, odd.data() + offsets[chunk], odd.data() + offsets[chunk + 1], level);
+    });
+
+    return odd;
+}
@@ -0,0 +1,1267 @@
+#pragma once
+
+#include "csr_graph.h"
+#include "dynamic_graph.h"
+#include "graph_snapshot.h"
+#include "indexed_heap.h"
+#include "search_workspace.h"
+#include "thread_pool.h"
+#include "vertex_interner.h"
+#include "weight_filters.h"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+
+struct SearchStatistics {
+    std::size_t exploredVertices = 0;
+};
+
+
+// With Graph = DynamicWeightedCsrGraph<E> edges are inserted and removed in
+// place instead of being merged into a rebuilt graph on the next query.
+// With Graph = MappedWeightedCsrGraph<E> the graph is a read-only snapshot
+// opened by load(). Search scratch belongs to the caller, so threads that
+// query one instance each pass their own SearchWorkspace. A query that
+// merges pending edges or caches a comparison filter's selection still
+// updates the instance and must not overlap with other calls.
+template<typename V, typename E, typename Graph = WeightedCsrGraph<E>>
+class PathFinder {
+public:
+    using VertexId = CsrGraph::VertexId;
+
+    static constexpr bool DYNAMIC = DynamicGraph<Graph>;
+    static constexpr bool MAPPED = MappedGraph<Graph>;
+
+    // Maps a snapshot written by save() without reading the arrays in it.
+    static PathFinder load(const std::string& path) requires MAPPED && std::same_as<V, std::string> {
+        auto snapshot = std::make_shared<const GraphSnapshot>(path);
+
+        PathFinder pathfinder{};
+        pathfinder.interner = MappedVertexInterner(snapshot);
+        pathfinder.graph = Graph(snapshot, SnapshotSection::Offsets, SnapshotSection::Neighbors, SnapshotSection::Weights);
+        pathfinder.reverseGraph = Graph(
+            snapshot,
+            SnapshotSection::ReverseOffsets,
+            SnapshotSection::ReverseNeighbors,
+            SnapshotSection::ReverseWeights
+        );
+        pathfinder.reverseGraphStale = false;
+
+        return pathfinder;
+    }
+
+    // Writes labels, the graph and its reverse in the snapshot format, so
+    // both search directions are ready as soon as the file is mapped.
+    void save(const std::string& path) requires std::same_as<V, std::string> && (!DYNAMIC) {
+        static_assert(std::is_trivially_copyable_v<E>, "snapshot weights are stored as raw bytes");
+
+        const auto& forward = frozenGraph();
+        const auto& backward = frozenReverseGraph();
+
+        SnapshotWriter writer{path, interner.size(), sizeof(E)};
+        writer.writeLabels(interner.tables());
+        writer.writeGraph(forward, SnapshotSection::Offsets, SnapshotSection::Neighbors);
+        writer.write(SnapshotSection::Weights, forward.allWeights());
+        writer.writeGraph(backward, SnapshotSection::ReverseOffsets, SnapshotSection::ReverseNeighbors);
+        writer.write(SnapshotSection::ReverseWeights, backward.allWeights());
+        writer.commit();
+    }
+
+    void add(const V vertex1, const V vertex2, const E edge) requires (!MAPPED) {
+        auto from = interner.intern(vertex1);
+        auto to = interner.intern(vertex2);
+
+        if constexpr (DYNAMIC) {
+            graph.addVertices(interner.size());
+            graph.insert(from, to, edge);
+
+            if (!reverseGraphStale) {
+                reverseGraph.addVertices(interner.size());
+                reverseGraph.insert(to, from, edge);
+            }
+
+            refreshSelection(from);
+        } else {
+            pendingEdges.push_back(
+                {from, to, edge}
+            );
+        }
+    }
+
+    // Removes one edge with exactly this weight, if there is one.
+    bool remove(const V& vertex1, const V& vertex2, const E& edge) requires DYNAMIC {
+        auto from = interner.find(vertex1);
+        auto to = interner.find(vertex2);
+
+        if (!from || !to || !graph.erase(*from, *to, edge)) {
+            return false;
+        }
+
+        if (!reverseGraphStale) {
+            reverseGraph.erase(*to, *from, edge);
+        }
+
+        refreshSelection(*from);
+        return true;
+    }
+
+    // Lowest-cost path from vertex1 to vertex2 using only edges whose weight
+    // passes the filter. Weights must be non-negative. Returns no edges when
+    // the endpoints coincide or no such path exists. The search allocates its
+    // scratch per call; pass a SearchWorkspace to reuse it across queries.
+    std::vector<std::tuple<V, V, E>> find(
+        const V& vertex1,
+        const V& vertex2,
+        const std::function<bool(E)>& filter,
+        SearchStatistics* statistics = nullptr
+    ) {
+        SearchWorkspace<E> workspace{};
+        return findPath(vertex1, vertex2, filter, workspace, statistics);
+    };
+
+    std::vector<std::tuple<V, V, E>> find(
+        const V& vertex1,
+        const V& vertex2,
+        const std::function<bool(E)>& filter,
+        SearchWorkspace<E>& workspace,
+        SearchStatistics* statistics = nullptr
+    ) {
+        return findPath(vertex1, vertex2, filter, workspace, statistics);
+    }
+
+    // Same search with the filter inlined into the edge scan instead of
+    // dispatched through std::function.
+    template <std::predicate<const E&> Filter>
+    std::vector<std::tuple<V, V, E>> find(
+        const V& vertex1,
+        const V& vertex2,
+        const Filter& filter,
+        SearchStatistics* statistics = nullptr
+    ) {
+        SearchWorkspace<E> workspace{};
+        return findPath(vertex1, vertex2, filter, workspace, statistics);
+    }
+
+    template <std::predicate<const E&> Filter>
+    std::vector<std::tuple<V, V, E>> find(
+        const V& vertex1,
+        const V& vertex2,
+        const Filter& filter,
+        SearchWorkspace<E>& workspace,
+        SearchStatistics* statistics = nullptr
+    ) {
+        return findPath(vertex1, vertex2, filter, workspace, statistics);
+    }
+
+    // Same result cost as find, found by growing one search from each end
+    // and stopping once the two frontiers can no longer improve on the best
+    // meeting point.
+    template <std::predicate<const E&> Filter>
+    std::vector<std::tuple<V, V, E>> findBidirectional(
+        const V& vertex1,
+        const V& vertex2,
+        const Filter& filter,
+        SearchStatistics* statistics = nullptr
+    ) {
+        auto source = interner.find(vertex1);
+        auto target = interner.find(vertex2);
+        if (!source || !target || *source == *target) {
+            return std::vector<std::tuple<V, V, E>>{};
+        }
+
+        return searchBidirectional(*source, *target, filter, statistics);
+    }
+
+    // Every stored edge whose weight passes the filter, without copying.
+    // The view is invalidated by the next add.
+    template <typename Filter>
+    auto filteredEdges(Filter filter) {
+        return frozenGraph().edges() | std::views::filter(byWeight(std::move(filter)));
+    }
+
+private:
+    using Interner = std::conditional_t<MAPPED, MappedVertexInterner, VertexInterner<V>>;
+
+    Interner interner{};
+    std::vector<std::tuple<VertexId, VertexId, E>> pendingEdges{};
+    Graph graph{};
+    Graph reverseGraph{};
+    bool reverseGraphStale = true;
+
+    std::variant<std::monostate, WeightAbove<E>, WeightBelow<E>, WeightBetween<E>> selectedFilter{};
+    std::vector<std::uint64_t> selection{};
+    std::uint64_t selectionCompactions = 0;
+
+    // Edges added since the last query are merged into a new frozen graph.
+    const Graph& frozenGraph() {
+        if constexpr (MAPPED) {
+            return graph;
+        } else {
+            return mergePendingEdges();
+        }
+    }
+
+    const Graph& mergePendingEdges() requires (!MAPPED) {
+        if (pendingEdges.empty()) {
+            return graph;
+        }
+
+        std::vector<std::tuple<VertexId, VertexId, E>> edges{};
+        edges.reserve(graph.edgeCount() + pendingEdges.size());
+
+        for (VertexId source = 0; source < graph.vertexCount(); source++) {
+            auto neighbors = graph.neighborsOf(source);
+            auto weights = graph.weightsOf(source);
+
+            for (std::size_t i = 0; i < neighbors.size(); i++) {
+                edges.push_back({source, neighbors[i], weights[i]});
+            }
+        }
+        edges.insert(edges.end(), pendingEdges.begin(), pendingEdges.end());
+
+        graph = Graph(interner.size(), edges);
+        pendingEdges = {};
+        selectedFilter = std::monostate{};
+        reverseGraphStale = true;
+
+        return graph;
+    }
+
+    // Only built once a bidirectional search needs it.
+    const Graph& frozenReverseGraph() {
+        const auto& forward = frozenGraph();
+
+        if constexpr (!MAPPED) {
+            if (reverseGraphStale) {
+                rebuildReverseGraph(forward);
+            }
+        }
+
+        return reverseGraph;
+    }
+
+    void rebuildReverseGraph(const Graph& forward) requires (!MAPPED) {
+        std::vector<std::tuple<VertexId, VertexId, E>> reversedEdges{};
+        reversedEdges.reserve(forward.edgeCount());
+
+        for (const auto& edge : forward.edges()) {
+            reversedEdges.push_back({edge.target, edge.source, edge.weight});
+        }
+
+        reverseGraph = Graph(interner.size(), reversedEdges);
+        reverseGraphStale = false;
+    }
+
+    template <typename Filter>
+    static auto byWeight(Filter filter) {
+        return [filter = std::move(filter)](const WeightedEdge<E>& edge) {
+            return filter(edge.weight);
+        };
+    }
+
+    // Comparison filters are evaluated over the whole weight column at once
+    // and the selection is reused until the filter or the graph changes.
+    template <WeightFilter<E> Filter>
+    const std::vector<std::uint64_t>& selectionFor(const Filter& filter) {
+        const auto& edges = frozenGraph();
+        auto cached = std::get_if<Filter>(&selectedFilter);
+
+        if (cached == nullptr || !(*cached == filter)) {
+            selectWeights(edges.allWeights(), filter, selection);
+            selectedFilter = filter;
+
+            if constexpr (DYNAMIC) {
+                selectionCompactions = edges.compactions();
+            }
+        }
+
+        return selection;
+    }
+
+    // Re-evaluates the cached selection for one row after an update, unless
+    // a compaction moved every edge and the selection has to start over.
+    void refreshSelection(VertexId vertex) requires DYNAMIC {
+        if (std::holds_alternative<std::monostate>(selectedFilter)) {
+            return;
+        }
+
+        if (graph.compactions() != selectionCompactions) {
+            selectedFilter = std::monostate{};
+            return;
+        }
+
+        auto weights = graph.allWeights();
+        selection.resize((weights.size() + 63) / 64, 0);
+
+        std::visit([&](const auto& filter) {
+            if constexpr (!std::same_as<std::decay_t<decltype(filter)>, std::monostate>) {
+                for (auto slot = graph.firstEdgeOf(vertex); slot < graph.lastEdgeOf(vertex); slot++) {
+                    auto bit = std::uint64_t{1} << (slot % 64);
+
+                    if (filter(weights[slot])) {
+                        selection[slot / 64] |= bit;
+                    } else {
+                        selection[slot / 64] &= ~bit;
+                    }
+                }
+            }
+        }, selectedFilter);
+    }
+
+    template <typename Filter>
+    std::vector<std::tuple<V, V, E>> findPath(
+        const V& vertex1,
+        const V& vertex2,
+        const Filter& filter,
+        SearchWorkspace<E>& workspace,
+        SearchStatistics* statistics
+    ) {
+        if constexpr (WeightFilter<Filter, E>) {
+            const auto& selected = selectionFor(filter);
+
+            return searchPath(vertex1, vertex2, workspace, statistics, [&selected](const WeightedEdge<E>& edge) {
+                return isSelected(selected, edge.index);
+            });
+        } else {
+            return searchPath(vertex1, vertex2, workspace, statistics, [&filter](const WeightedEdge<E>& edge) {
+                return filter(edge.weight);
+            });
+        }
+    }
+
+    template <typename Passes>
+    std::vector<std::tuple<V, V, E>> searchPath(
+        const V& vertex1,
+        const V& vertex2,
+        SearchWorkspace<E>& workspace,
+        SearchStatistics* statistics,
+        const Passes& passes
+    ) {
+        const auto& edges = frozenGraph();
+
+        auto source = interner.find(vertex1);
+        auto target = interner.find(vertex2);
+        if (!source || !target || *source == *target) {
+            return std::vector<std::tuple<V, V, E>>{};
+        }
+
+        workspace.reset(edges.vertexCount());
+        workspace.reach(*source, E{});
+        workspace.frontier.push(*source, E{});
+
+        while (!workspace.frontier.empty()) {
+            auto current = workspace.frontier.pop();
+
+            if (statistics) {
+                statistics->exploredVertices++;
+            }
+
+            if (current == *target) {
+                return reconstructPath(workspace.links, workspace.linkWeights, *source, current);
+            }
+
+            for (const auto& edge : edges.edgesOf(current) | std::views::filter(passes)) {
+                auto adjacent = edge.target;
+                E candidate = workspace.distances[current] + edge.weight;
+
+                if (workspace.reached(adjacent) && !(candidate < workspace.distances[adjacent])) {
+                    continue;
+                }
+
+                workspace.reach(adjacent, candidate);
+                workspace.links[adjacent] = current;
+                workspace.linkWeights[adjacent] = edge.weight;
+                workspace.frontier.pushOrDecrease(adjacent, candidate);
+            }
+        }
+
+        return std::vector<std::tuple<V, V, E>>{};
+    }
+
+    struct SearchSide {
+        std::vector<bool> reached;
+        std::vector<bool> settled;
+        std::vector<E> distances;
+        std::vector<VertexId> links;
+        std::vector<E> linkWeights;
+        IndexedDaryHeap<E> frontier;
+
+        SearchSide(std::size_t vertexCount, VertexId start)
+            : reached(vertexCount, false),
+              settled(vertexCount, false),
+              distances(vertexCount),
+              links(vertexCount),
+              linkWeights(vertexCount),
+              frontier(vertexCount) {
+            reached[start] = true;
+            distances[start] = E{};
+            frontier.push(start, E{});
+        }
+
+        E topDistance() const {
+            return frontier.priorityOf(frontier.top());
+        }
+    };
+
+    template <typename Filter>
+    std::vector<std::tuple<V, V, E>> searchBidirectional(
+        VertexId source,
+        VertexId target,
+        const Filter& filter,
+        SearchStatistics* statistics
+    ) {
+        const auto& forwardGraph = frozenGraph();
+        const auto& backwardGraph = frozenReverseGraph();
+        const std::size_t vertexCount = forwardGraph.vertexCount();
+
+        SearchSide forward{vertexCount, source};
+        SearchSide backward{vertexCount, target};
+        auto passes = [&filter](const WeightedEdge<E>& edge) {
+            return filter(edge.weight);
+        };
+
+        bool found = false;
+        E best{};
+        VertexId meeting = source;
+
+        while (!forward.frontier.empty() && !backward.frontier.empty()) {
+            if (found && !(forward.topDistance() + backward.topDistance() < best)) {
+                break;
+            }
+
+            bool forwardTurn = forward.frontier.size() <= backward.frontier.size();
+            auto& side = forwardTurn ? forward : backward;
+            auto& other = forwardTurn ? backward : forward;
+            const auto& edges = forwardTurn ? forwardGraph : backwardGraph;
+
+            auto current = side.frontier.pop();
+            side.settled[current] = true;
+
+            if (statistics) {
+                statistics->exploredVertices++;
+            }
+
+            for (const auto& edge : edges.edgesOf(current) | std::views::filter(passes)) {
+                auto adjacent = edge.target;
+                E candidate = side.distances[current] + edge.weight;
+
+                if (!side.settled[adjacent] && (!side.reached[adjacent] || candidate < side.distances[adjacent])) {
+                    side.reached[adjacent] = true;
+                    side.distances[adjacent] = candidate;
+                    side.links[adjacent] = current;
+                    side.linkWeights[adjacent] = edge.weight;
+                    side.frontier.pushOrDecrease(adjacent, candidate);
+                }
+
+                if (other.reached[adjacent]) {
+                    E total = side.distances[adjacent] + other.distances[adjacent];
+
+                    if (!found || total < best) {
+                        found = true;
+                        best = total;
+                        meeting = adjacent;
+                    }
+                }
+            }
+        }
+
+        if (!found) {
+            return std::vector<std::tuple<V, V, E>>{};
+        }
+
+        auto path = reconstructPath(forward.links, forward.linkWeights, source, meeting);
+
+        for (auto index = meeting; index != target; index = backward.links[index]) {
+            path.push_back({
+                V(interner.labelOf(index)),
+                V(interner.labelOf(backward.links[index])),
+                backward.linkWeights[index]
+            });
+        }
+
+        return path;
+    }
+
+    std::vector<std::tuple<V, V, E>> reconstructPath(
+        const std::vector<VertexId>& predecessors,
+        const std::vector<E>& arrivalEdges,
+        VertexId first,
+        VertexId last
+    ) const {
+        std::size_t length = 0;
+        for (auto index = last; index != first; index = predecessors[index]) {
+            length++;
+        }
+
+        std::vector<std::tuple<V, V, E>> path(length);
+        for (auto index = last; index != first; index = predecessors[index]) {
+            path[--length] = {
+                V(interner.labelOf(predecessors[index])),
+                V(interner.labelOf(index)),
+                arrivalEdges[index]
+            };
+        }
+
+        return path;
+    }
+};
+
+
+// How BreadthFirstSearch stores adjacency. WithReverse keeps the reverse
+// graph next to the forward one; searches record only levels and pick each
+// lowest-id parent from it once the target is found. ForwardOnly halves the
+// adjacency memory of a serial instance, at the cost of tracking parents
+// during every search, which makes queries noticeably slower.
+enum class BfsAdjacency {
+    WithReverse,
+    ForwardOnly,
+};
+
+
+// With Graph = DynamicCsrGraph edges can be added and removed after
+// construction. Updates must not run concurrently with queries. With
+// Graph = MappedCsrGraph the graph is a read-only snapshot opened by load().
+template <typename V, typename Graph = CsrGraph>
+class BreadthFirstSearch {
+public:
+    using VertexId = CsrGraph::VertexId;
+
+    static constexpr bool DYNAMIC = DynamicGraph<Graph>;
+    static constexpr bool MAPPED = MappedGraph<Graph>;
+
+    // Maps a snapshot written by save() without reading the arrays in it.
+    static BreadthFirstSearch load(const std::string& path, std::size_t threadCount = 1)
+        requires MAPPED && std::same_as<V, std::string> {
+        auto snapshot = std::make_shared<const GraphSnapshot>(path);
+
+        BreadthFirstSearch bfs{};
+        bfs.interner = MappedVertexInterner(snapshot);
+        bfs.graph = Graph(snapshot, SnapshotSection::Offsets, SnapshotSection::Neighbors);
+        bfs.reverseGraph = Graph(snapshot, SnapshotSection::ReverseOffsets, SnapshotSection::ReverseNeighbors);
+        bfs.reverseGraphBuilt = true;
+
+        if (threadCount > 1) {
+            bfs.pool = std::make_unique<ThreadPool>(threadCount);
+        }
+
+        return bfs;
+    }
+
+    void save(const std::string& path) const requires std::same_as<V, std::string> && (!DYNAMIC) {
+        SnapshotWriter writer{path, interner.size(), 0};
+        writer.writeLabels(interner.tables());
+        writer.writeGraph(graph, SnapshotSection::Offsets, SnapshotSection::Neighbors);
+
+        if (reverseGraphBuilt) {
+            writer.writeGraph(reverseGraph, SnapshotSection::ReverseOffsets, SnapshotSection::ReverseNeighbors);
+        } else {
+            writer.writeGraph(reversed(graph), SnapshotSection::ReverseOffsets, SnapshotSection::ReverseNeighbors);
+        }
+
+        writer.commit();
+    }
+
+    // With threadCount > 1 each frontier level is expanded across a thread
+    // pool. Both modes return the same path. The parallel mode always keeps
+    // the reverse graph; a ForwardOnly serial instance builds it on the
+    // first bidirectional search.
+    BreadthFirstSearch(
+        const std::vector<std::pair<V, V>>& adjacentVertices,
+        std::size_t threadCount = 1,
+        BfsAdjacency adjacency = BfsAdjacency::WithReverse
+    ) {
+        std::vector<std::pair<VertexId, VertexId>> edges{};
+        edges.reserve(adjacentVertices.size());
+
+        for (auto& adjacentPair : adjacentVertices) {
+            auto from = interner.intern(adjacentPair.first);
+            auto to = interner.intern(adjacentPair.second);
+
+            edges.push_back({from, to});
+        }
+
+        graph = Graph(interner.size(), edges);
+
+        if (threadCount > 1 || adjacency == BfsAdjacency::WithReverse) {
+            reverseGraph = reversed(graph);
+            reverseGraphBuilt = true;
+        }
+
+        if (threadCount > 1) {
+            pool = std::make_unique<ThreadPool>(threadCount);
+        }
+    }
+
+    std::size_t threadCount() const {
+        return pool ? pool->threadCount() : 1;
+    }
+
+    void addEdge(const V& vertex1, const V& vertex2) requires DYNAMIC {
+        auto from = interner.intern(vertex1);
+        auto to = interner.intern(vertex2);
+
+        graph.addVertices(interner.size());
+        graph.insert(from, to);
+
+        if (reverseGraphBuilt) {
+            reverseGraph.addVertices(interner.size());
+            reverseGraph.insert(to, from);
+        }
+    }
+
+    // Removes one edge between the vertices, if there is one.
+    bool removeEdge(const V& vertex1, const V& vertex2) requires DYNAMIC {
+        auto from = interner.find(vertex1);
+        auto to = interner.find(vertex2);
+
+        if (!from || !to || !graph.erase(*from, *to)) {
+            return false;
+        }
+
+        if (reverseGraphBuilt) {
+            reverseGraph.erase(*to, *from);
+        }
+        return true;
+    }
+
+    // Among all shortest paths, returns the one that steps back to the
+    // lowest-id predecessor at every hop, so the result does not depend on
+    // the order in which a level was expanded. A serial search allocates its
+    // scratch per call; pass a LevelWorkspace to reuse it across queries.
+    std::vector<V> getShortestPathBetween(
+        const V& vertex1,
+        const V& vertex2,
+        SearchStatistics* statistics = nullptr
+    ) const {
+        if (!pool) {
+            LevelWorkspace workspace{};
+            return getShortestPathBetween(vertex1, vertex2, workspace, statistics);
+        }
+
+        auto source = interner.find(vertex1);
+        auto target = interner.find(vertex2);
+        if (!source || !target) {
+            return std::vector<V>{};
+        }
+
+        if (*source == *target) {
+            return {vertex1};
+        }
+
+        std::vector<std::uint32_t> levels(graph.vertexCount(), UNVISITED);
+
+        if (!assignLevelsInParallel(*source, *target, levels, statistics)) {
+            return std::vector<V>{};
+        }
+
+        return reconstructPath(*target, [&levels](VertexId vertex) {
+            return levels[vertex];
+        });
+    }
+
+    std::vector<V> getShortestPathBetween(
+        const V& vertex1,
+        const V& vertex2,
+        LevelWorkspace& workspace,
+        SearchStatistics* statistics = nullptr
+    ) const {
+        auto source = interner.find(vertex1);
+        auto target = interner.find(vertex2);
+        if (!source || !target) {
+            return std::vector<V>{};
+        }
+
+        if (*source == *target) {
+            return {vertex1};
+        }
+
+        if (reverseGraphBuilt) {
+            if (!assignLevels<false>(*source, *target, workspace, statistics)) {
+                return std::vector<V>{};
+            }
+
+            return reconstructPath(*target, [&workspace](VertexId vertex) {
+                return workspace.reached(vertex) ? workspace.levels[vertex] : UNVISITED;
+            });
+        }
+
+        if (!assignLevels<true>(*source, *target, workspace, statistics)) {
+            return std::vector<V>{};
+        }
+
+        return tracePath(*target, workspace.levels[*target], [&workspace](VertexId vertex) {
+            return workspace.parents[vertex];
+        });
+    }
+
+    // Answers many queries at once, in input order. Queries that share a
+    // source are served by a single traversal that stops once all of their
+    // targets are reached; distinct sources are spread across the pool.
+    std::vector<std::vector<V>> getShortestPathsBetween(const std::vector<std::pair<V, V>>& queries) const {
+        std::vector<std::vector<V>> results(queries.size());
+        std::vector<BatchQuery> resolved{};
+        resolved.reserve(queries.size());
+
+        for (std::size_t i = 0; i < queries.size(); i++) {
+            auto source = interner.find(queries[i].first);
+            auto target = interner.find(queries[i].second);
+            if (!source || !target) {
+                continue;
+            }
+
+            if (*source == *target) {
+                results[i] = {queries[i].first};
+            } else {
+                resolved.push_back({*source, *target, i});
+            }
+        }
+
+        std::sort(resolved.begin(), resolved.end(), [](const BatchQuery& left, const BatchQuery& right) {
+            return left.source < right.source;
+        });
+
+        std::vector<std::span<const BatchQuery>> groups{};
+        for (std::size_t begin = 0, end = 0; begin < resolved.size(); begin = end) {
+            while (end < resolved.size() && resolved[end].source == resolved[begin].source) {
+                end++;
+            }
+
+            groups.push_back(std::span<const BatchQuery>(resolved).subspan(begin, end - begin));
+        }
+
+        const std::size_t taskCount = std::min(groups.size(), threadCount());
+
+        auto answerGroups = [&](std::size_t task) {
+            BatchScratch scratch{graph.vertexCount()};
+
+            for (std::size_t group = task; group < groups.size(); group += taskCount) {
+                if (reverseGraphBuilt) {
+                    answerBatchGroup<false>(groups[group], scratch, results);
+                } else {
+                    answerBatchGroup<true>(groups[group], scratch, results);
+                }
+            }
+        };
+
+        if (pool) {
+            pool->run(taskCount, answerGroups);
+        } else if (taskCount > 0) {
+            answerGroups(0);
+        }
+
+        return results;
+    }
+
+    // Expands a whole level at a time from whichever end has the smaller
+    // frontier. Returns a shortest path, though not necessarily the same one
+    // as getShortestPathBetween when several exist.
+    std::vector<V> getShortestPathBidirectional(
+        const V& vertex1,
+        const V& vertex2,
+        SearchStatistics* statistics = nullptr
+    ) {
+        auto source = interner.find(vertex1);
+        auto target = interner.find(vertex2);
+        if (!source || !target) {
+            return std::vector<V>{};
+        }
+
+        if (*source == *target) {
+            return {vertex1};
+        }
+
+        const auto& backwardGraph = frozenReverseGraph();
+        const std::size_t vertexCount = graph.vertexCount();
+
+        std::vector<std::uint32_t> forwardLevels(vertexCount, UNVISITED);
+        std::vector<std::uint32_t> backwardLevels(vertexCount, UNVISITED);
+        std::vector<VertexId> forwardLinks(vertexCount);
+        std::vector<VertexId> backwardLinks(vertexCount);
+
+        std::vector<VertexId> forwardFrontier{*source};
+        std::vector<VertexId> backwardFrontier{*target};
+        std::vector<VertexId> nextFrontier{};
+
+        forwardLevels[*source] = 0;
+        backwardLevels[*target] = 0;
+
+        auto bestLength = UNVISITED;
+        VertexId meetingForward = *source;
+        VertexId meetingBackward = *target;
+
+        while (bestLength == UNVISITED && !forwardFrontier.empty() && !backwardFrontier.empty()) {
+            bool forwardTurn = forwardFrontier.size() <= backwardFrontier.size();
+
+            auto& frontier = forwardTurn ? forwardFrontier : backwardFrontier;
+            auto& levels = forwardTurn ? forwardLevels : backwardLevels;
+            auto& links = forwardTurn ? forwardLinks : backwardLinks;
+            const auto& otherLevels = forwardTurn ? backwardLevels : forwardLevels;
+            const auto& edges = forwardTurn ? graph : backwardGraph;
+
+            nextFrontier.clear();
+
+            for (auto current : frontier) {
+                if (statistics) {
+                    statistics->exploredVertices++;
+                }
+
+                for (auto adjacent : edges.neighborsOf(current)) {
+                    if (otherLevels[adjacent] != UNVISITED && levels[current] + 1 + otherLevels[adjacent] < bestLength) {
+                        bestLength = levels[current] + 1 + otherLevels[adjacent];
+                        meetingForward = forwardTurn ? current : adjacent;
+                        meetingBackward = forwardTurn ? adjacent : current;
+                    }
+
+                    if (levels[adjacent] == UNVISITED) {
+                        levels[adjacent] = levels[current] + 1;
+                        links[adjacent] = current;
+                        nextFrontier.push_back(adjacent);
+                    }
+                }
+            }
+
+            std::swap(frontier, nextFrontier);
+        }
+
+        if (bestLength == UNVISITED) {
+            return std::vector<V>{};
+        }
+
+        std::vector<V> path(bestLength + 1);
+        std::size_t position = forwardLevels[meetingForward];
+
+        for (auto index = meetingForward; ; index = forwardLinks[index]) {
+            path[position] = V(interner.labelOf(index));
+
+            if (position-- == 0) {
+                break;
+            }
+        }
+
+        position = forwardLevels[meetingForward] + 1;
+        for (auto index = meetingBackward; ; index = backwardLinks[index]) {
+            path[position++] = V(interner.labelOf(index));
+
+            if (index == *target) {
+                break;
+            }
+        }
+
+        return path;
+    }
+
+private:
+    static constexpr std::uint32_t UNVISITED = std::numeric_limits<std::uint32_t>::max();
+
+    // Direction-optimizing thresholds from Beamer et al.
+    static constexpr std::size_t TOP_DOWN_TO_BOTTOM_UP = 14;
+    static constexpr std::size_t BOTTOM_UP_TO_TOP_DOWN = 24;
+    static constexpr std::size_t TASKS_PER_THREAD = 4;
+
+    using Interner = std::conditional_t<MAPPED, MappedVertexInterner, VertexInterner<V>>;
+
+    Interner interner{};
+    Graph graph{};
+    Graph reverseGraph{};
+    bool reverseGraphBuilt = false;
+    std::unique_ptr<ThreadPool> pool{};
+
+    BreadthFirstSearch() = default;
+
+    static Graph reversed(const Graph& forward) requires (!MAPPED) {
+        std::vector<std::pair<VertexId, VertexId>> reversedEdges{};
+        reversedEdges.reserve(forward.edgeCount());
+
+        for (VertexId source = 0; source < forward.vertexCount(); source++) {
+            for (auto target : forward.neighborsOf(source)) {
+                reversedEdges.push_back({target, source});
+            }
+        }
+
+        return Graph(forward.vertexCount(), reversedEdges);
+    }
+
+    const Graph& frozenReverseGraph() {
+        if constexpr (!MAPPED) {
+            if (!reverseGraphBuilt) {
+                reverseGraph = reversed(graph);
+                reverseGraphBuilt = true;
+            }
+        }
+
+        return reverseGraph;
+    }
+
+    struct BatchQuery {
+        VertexId source;
+        VertexId target;
+        std::size_t index;
+    };
+
+    // Levels, parents and queue for one traversal. Only the vertices left in
+    // the queue were touched, so resetting costs as much as the search did.
+    struct BatchScratch {
+        std::vector<std::uint32_t> levels;
+        std::vector<VertexId> parents;
+        std::vector<VertexId> vertexQueue;
+        std::vector<bool> targets;
+
+        explicit BatchScratch(std::size_t vertexCount)
+            : levels(vertexCount, UNVISITED), parents(vertexCount), vertexQueue(vertexCount), targets(vertexCount, false) {}
+    };
+
+    // Without the reverse graph each vertex records its lowest-id parent on
+    // the level above while the search runs.
+    template <bool RECORD_PARENTS>
+    void answerBatchGroup(
+        std::span<const BatchQuery> group,
+        BatchScratch& scratch,
+        std::vector<std::vector<V>>& results
+    ) const {
+        std::size_t remainingTargets = 0;
+        for (auto& query : group) {
+            if (!scratch.targets[query.target]) {
+                scratch.targets[query.target] = true;
+                remainingTargets++;
+            }
+        }
+
+        auto source = group.front().source;
+        std::size_t queueHead = 0;
+        std::size_t queueTail = 0;
+
+        scratch.levels[source] = 0;
+        scratch.vertexQueue[queueTail++] = source;
+
+        while (queueHead < queueTail && remainingTargets > 0) {
+            auto current = scratch.vertexQueue[queueHead++];
+            auto level = scratch.levels[current];
+
+            for (auto adjacent : graph.neighborsOf(current)) {
+                if (scratch.levels[adjacent] != UNVISITED) {
+                    if constexpr (RECORD_PARENTS) {
+                        if (scratch.levels[adjacent] == level + 1 && current < scratch.parents[adjacent]) {
+                            scratch.parents[adjacent] = current;
+                        }
+                    }
+                    continue;
+                }
+
+                scratch.levels[adjacent] = level + 1;
+                scratch.vertexQueue[queueTail++] = adjacent;
+
+                if constexpr (RECORD_PARENTS) {
+                    scratch.parents[adjacent] = current;
+                }
+
+                if (!scratch.targets[adjacent] || --remainingTargets > 0) {
+                    continue;
+                }
+
+                if constexpr (RECORD_PARENTS) {
+                    // Targets found earlier had the rest of their parents'
+                    // level expanded; only the ones on this last level did not.
+                    auto onLastLevel = [&scratch, level](VertexId vertex) {
+                        return scratch.targets[vertex] && scratch.levels[vertex] == level + 1;
+                    };
+
+                    VertexId highestParent = 0;
+                    for (auto& query : group) {
+                        if (onLastLevel(query.target)) {
+                            highestParent = std::max(highestParent, scratch.parents[query.target]);
+                        }
+                    }
+
+                    lowerParents(
+                        std::span<const VertexId>(scratch.vertexQueue).subspan(queueHead, queueTail - queueHead),
+                        highestParent,
+                        [&scratch, level](VertexId vertex) {
+                            return scratch.levels[vertex] == level;
+                        },
+                        onLastLevel,
+                        scratch.parents
+                    );
+                }
+            }
+        }
+
+        for (auto& query : group) {
+            if (scratch.levels[query.target] != UNVISITED) {
+                if constexpr (RECORD_PARENTS) {
+                    results[query.index] = tracePath(query.target, scratch.levels[query.target], [&scratch](VertexId vertex) {
+                        return scratch.parents[vertex];
+                    });
+                } else {
+                    results[query.index] = reconstructPath(query.target, [&scratch](VertexId vertex) {
+                        return scratch.levels[vertex];
+                    });
+                }
+            }
+
+            scratch.targets[query.target] = false;
+        }
+
+        for (std::size_t i = 0; i < queueTail; i++) {
+            scratch.levels[scratch.vertexQueue[i]] = UNVISITED;
+        }
+    }
+
+    template <bool RECORD_PARENTS>
+    bool assignLevels(
+        VertexId source,
+        VertexId target,
+        LevelWorkspace& workspace,
+        SearchStatistics* statistics
+    ) const {
+        workspace.reset(graph.vertexCount());
+
+        std::size_t queueHead = 0;
+        std::size_t queueTail = 0;
+
+        workspace.reach(source, 0);
+        workspace.vertexQueue[queueTail++] = source;
+
+        // With RECORD_PARENTS each vertex keeps its lowest-id parent on the
+        // level above.
+        while (queueHead < queueTail) {
+            auto current = workspace.vertexQueue[queueHead++];
+            auto level = workspace.levels[current];
+
+            if (statistics) {
+                statistics->exploredVertices++;
+            }
+
+            for (auto adjacent : graph.neighborsOf(current)) {
+                if (workspace.reached(adjacent)) {
+                    if constexpr (RECORD_PARENTS) {
+                        if (workspace.levels[adjacent] == level + 1 && current < workspace.parents[adjacent]) {
+                            workspace.parents[adjacent] = current;
+                        }
+                    }
+                    continue;
+                }
+
+                workspace.reach(adjacent, level + 1);
+
+                if constexpr (RECORD_PARENTS) {
+                    workspace.parents[adjacent] = current;
+                }
+
+                if (adjacent == target) {
+                    if constexpr (RECORD_PARENTS) {
+                        lowerParents(
+                            std::span<const VertexId>(workspace.vertexQueue).subspan(queueHead, queueTail - queueHead),
+                            current,
+                            [&workspace, level](VertexId vertex) {
+                                return workspace.levels[vertex] == level;
+                            },
+                            [target](VertexId vertex) {
+                                return vertex == target;
+                            },
+                            workspace.parents
+                        );
+                    }
+
+                    return true;
+                }
+
+                workspace.vertexQueue[queueTail++] = adjacent;
+            }
+        }
+
+        return false;
+    }
+
+    // The search stops before the rest of the level above its last targets
+    // is expanded. Those vertices are the front of the queue, so one pass
+    // over their edges gives every such target its lowest-id parent without
+    // finishing the level. Only candidates below the highest current parent
+    // can improve on one, so the rest are not scanned.
+    template <typename OnLevel, typename IsTarget>
+    void lowerParents(
+        std::span<const VertexId> queued,
+        VertexId highestParent,
+        const OnLevel& onLevel,
+        const IsTarget& isTarget,
+        std::vector<VertexId>& parents
+    ) const {
+        for (auto candidate : queued) {
+            if (!onLevel(candidate)) {
+                break;
+            }
+
+            if (candidate >= highestParent) {
+                continue;
+            }
+
+            for (auto adjacent : graph.neighborsOf(candidate)) {
+                if (isTarget(adjacent) && candidate < parents[adjacent]) {
+                    parents[adjacent] = candidate;
+                }
+            }
+        }
+    }
+
+    bool assignLevelsInParallel(
+        VertexId source,
+        VertexId target,
+        std::vector<std::uint32_t>& levels,
+        SearchStatistics* statistics
+    ) const {
+        const std::size_t taskCount = pool->threadCount() * TASKS_PER_THREAD;
+        const std::size_t vertexCount = graph.vertexCount();
+
+        std::vector<std::vector<VertexId>> discovered(taskCount);
+        std::vector<std::size_t> discoveredEdges(taskCount);
+
+        std::vector<VertexId> frontier{source};
+        std::size_t frontierEdges = graph.neighborsOf(source).size();
+        std::size_t unexploredEdges = graph.edgeCount();
+        bool bottomUp = false;
+
+        levels[source] = 0;
+
+        for (std::uint32_t level = 0; !frontier.empty(); level++) {
+            if (!bottomUp && frontierEdges > unexploredEdges / TOP_DOWN_TO_BOTTOM_UP) {
+                bottomUp = true;
+            } else if (bottomUp && frontier.size() < vertexCount / BOTTOM_UP_TO_TOP_DOWN) {
+                bottomUp = false;
+            }
+
+            unexploredEdges -= std::min(unexploredEdges, frontierEdges);
+
+            if (statistics) {
+                statistics->exploredVertices += frontier.size();
+            }
+
+            pool->run(taskCount, [&](std::size_t task) {
+                discovered[task].clear();
+                discoveredEdges[task] = 0;
+
+                if (bottomUp) {
+                    expandBottomUp(level, vertexCount * task / taskCount, vertexCount * (task + 1) / taskCount, levels, discovered[task]);
+                } else {
+                    expandTopDown(level, frontier, frontier.size() * task / taskCount, frontier.size() * (task + 1) / taskCount, levels, discovered[task]);
+                }
+
+                for (auto vertex : discovered[task]) {
+                    discoveredEdges[task] += graph.neighborsOf(vertex).size();
+                }
+            });
+
+            if (levels[target] != UNVISITED) {
+                return true;
+            }
+
+            frontier.clear();
+            frontierEdges = 0;
+
+            for (std::size_t task = 0; task < taskCount; task++) {
+                frontier.insert(frontier.end(), discovered[task].begin(), discovered[task].end());
+                frontierEdges += discoveredEdges[task];
+            }
+        }
+
+        return false;
+    }
+
+    void expandTopDown(
+        std::uint32_t level,
+        const std::vector<VertexId>& frontier,
+        std::size_t begin,
+        std::size_t end,
+        std::vector<std::uint32_t>& levels,
+        std::vector<VertexId>& discovered
+    ) const {
+        for (std::size_t i = begin; i < end; i++) {
+            for (auto adjacent : graph.neighborsOf(frontier[i])) {
+                std::atomic_ref<std::uint32_t> adjacentLevel{levels[adjacent]};
+                auto expected = UNVISITED;
+
+                if (adjacentLevel.load(std::memory_order_relaxed) == UNVISITED
+                    && adjacentLevel.compare_exchange_strong(expected, level + 1, std::memory_order_relaxed)) {
+                    discovered.push_back(adjacent);
+                }
+            }
+        }
+    }
+
+    // Every unvisited vertex looks for a parent in the current frontier and
+    // stops at the first one, instead of the frontier pushing to everything.
+    void expandBottomUp(
+        std::uint32_t level,
+        std::size_t begin,
+        std::size_t end,
+        std::vector<std::uint32_t>& levels,
+        std::vector<VertexId>& discovered
+    ) const {
+        for (std::size_t vertex = begin; vertex < end; vertex++) {
+            std::atomic_ref<std::uint32_t> vertexLevel{levels[vertex]};
+
+            if (vertexLevel.load(std::memory_order_relaxed) != UNVISITED) {
+                continue;
+            }
+
+            for (auto parent : reverseGraph.neighborsOf(static_cast<VertexId>(vertex))) {
+                if (std::atomic_ref<std::uint32_t>{levels[parent]}.load(std::memory_order_relaxed) == level) {
+                    vertexLevel.store(level + 1, std::memory_order_relaxed);
+                    discovered.push_back(static_cast<VertexId>(vertex));
+                    break;
+                }
+            }
+        }
+    }
+
+    template <typename ParentOf>
+    std::vector<V> tracePath(VertexId last, std::uint32_t length, const ParentOf& parentOf) const {
+        std::vector<V> path(length + 1);
+        auto current = last;
+
+        for (auto level = length; level > 0; level--) {
+            path[level] = V(interner.labelOf(current));
+            current = parentOf(current);
+        }
+
+        path[0] = V(interner.labelOf(current));
+
+        return path;
+    }
+
+    // For searches that keep only levels: the lowest-id parent is found by
+    // scanning the reverse graph.
+    template <typename LevelOf>
+    std::vector<V> reconstructPath(VertexId last, const LevelOf& levelOf) const {
+        std::vector<V> path(levelOf(last) + 1);
+        auto current = last;
+
+        for (auto level = levelOf(last); level > 0; level--) {
+            path[level] = V(interner.labelOf(current));
+
+            auto predecessor = UNVISITED;
+            for (auto parent : reverseGraph.neighborsOf(current)) {
+                if (levelOf(parent) == level - 1 && parent < predecessor) {
+                    predecessor = parent;
+                }
+            }
+
+            current = predecessor;
+        }
+
+        path[0] = V(interner.labelOf(current));
+
+        return path;
+    }
+};
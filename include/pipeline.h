@@ -0,0 +1,217 @@
+#pragma once
+
+#include "parallel_collections.h"
+#include "thread_pool.h"
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+// Lazy map / filter chains over a range, ended by a reduction:
+//
+//     pipe(values) | map(f) | filter(p) | reduce(op, initial)
+//
+// Nothing runs until the terminal stage, which makes a single pass over
+// the source and pushes each element through every stage in turn, so no
+// stage stores its output. Before the terminal stage a pipeline is also a
+// std::ranges range over the mapped and filtered elements.
+namespace pipeline {
+
+template <typename Function>
+struct Map {
+    Function function;
+
+    template <typename Value, typename Next>
+    void operator()(Value&& value, const Next& next) const {
+        next(std::invoke(function, std::forward<Value>(value)));
+    }
+
+    auto adaptor() const {
+        return std::views::transform(function);
+    }
+};
+
+
+template <typename Predicate>
+struct Filter {
+    Predicate predicate;
+
+    template <typename Value, typename Next>
+    void operator()(Value&& value, const Next& next) const {
+        if (std::invoke(predicate, std::as_const(value))) {
+            next(std::forward<Value>(value));
+        }
+    }
+
+    auto adaptor() const {
+        return std::views::filter(predicate);
+    }
+};
+
+
+template <typename Operation, typename T>
+struct Reduce {
+    Operation operation;
+    T initial;
+};
+
+
+// Splits a sized random-access source across the pool. As with
+// std::reduce, operation must be associative and commutative.
+template <typename Operation, typename T>
+struct ParallelReduce {
+    Operation operation;
+    T initial;
+    ThreadPool* pool;
+};
+
+
+template <typename Function>
+Map<Function> map(Function function) {
+    return {std::move(function)};
+}
+
+template <typename Predicate>
+Filter<Predicate> filter(Predicate predicate) {
+    return {std::move(predicate)};
+}
+
+template <typename Operation, typename T>
+Reduce<Operation, T> reduce(Operation operation, T initial) {
+    return {std::move(operation), std::move(initial)};
+}
+
+template <typename Operation, typename T>
+ParallelReduce<Operation, T> parallelReduce(Operation operation, T initial, ThreadPool& pool) {
+    return {std::move(operation), std::move(initial), &pool};
+}
+
+
+template <std::ranges::view Source, typename View, typename... Stages>
+class Pipeline {
+public:
+    Pipeline(Source source, View view, std::tuple<Stages...> stages)
+        : source(std::move(source)), view(std::move(view)), stages(std::move(stages)) {}
+
+    auto begin() {
+        return std::ranges::begin(view);
+    }
+
+    auto end() {
+        return std::ranges::end(view);
+    }
+
+    template <typename Function>
+    friend auto operator|(Pipeline pipeline, Map<Function> stage) {
+        return std::move(pipeline).then(std::move(stage));
+    }
+
+    template <typename Predicate>
+    friend auto operator|(Pipeline pipeline, Filter<Predicate> stage) {
+        return std::move(pipeline).then(std::move(stage));
+    }
+
+    template <typename Operation, typename T>
+    friend T operator|(const Pipeline& pipeline, const Reduce<Operation, T>& stage) {
+        T accumulator = stage.initial;
+
+        pipeline.run(std::ranges::begin(pipeline.source), std::ranges::end(pipeline.source), [&](auto&& value) {
+            accumulator = std::invoke(stage.operation, std::move(accumulator), std::forward<decltype(value)>(value));
+        });
+
+        return accumulator;
+    }
+
+    template <typename Operation, typename T>
+        requires std::ranges::random_access_range<const Source> && std::ranges::sized_range<const Source>
+    friend T operator|(const Pipeline& pipeline, const ParallelReduce<Operation, T>& stage) {
+        std::vector<std::optional<T>> partials(collection_kernels::maximumChunks(*stage.pool));
+        auto first = std::ranges::begin(pipeline.source);
+
+        auto chunkCount = collection_kernels::forEachChunk(std::ranges::size(pipeline.source), *stage.pool, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            auto& partial = partials[chunk];
+
+            // Seeds each chunk with its first surviving value, so the main
+            // loop has no branch on whether the chunk has seen one yet.
+            auto position = first + begin;
+            for (; position != first + end && !partial; ++position) {
+                pipeline.push<0>(*position, [&](auto&& value) {
+                    partial.emplace(std::forward<decltype(value)>(value));
+                });
+            }
+
+            if (!partial) {
+                return;
+            }
+
+            T accumulator = std::move(*partial);
+            pipeline.run(position, first + end, [&](auto&& value) {
+                accumulator = std::invoke(stage.operation, std::move(accumulator), std::forward<decltype(value)>(value));
+            });
+            partial = std::move(accumulator);
+        });
+
+        T accumulator = stage.initial;
+        for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+            if (partials[chunk]) {
+                accumulator = std::invoke(stage.operation, std::move(accumulator), std::move(*partials[chunk]));
+            }
+        }
+
+        return accumulator;
+    }
+
+private:
+    Source source;
+    View view;
+    std::tuple<Stages...> stages;
+
+    template <typename Stage>
+    auto then(Stage stage) && {
+        auto extended = std::move(view) | stage.adaptor();
+
+        return Pipeline<Source, decltype(extended), Stages..., Stage>(
+            std::move(source),
+            std::move(extended),
+            std::tuple_cat(std::move(stages), std::tuple<Stage>(std::move(stage)))
+        );
+    }
+
+    template <std::size_t STAGE, typename Value, typename Sink>
+    void push(Value&& value, const Sink& sink) const {
+        if constexpr (STAGE == sizeof...(Stages)) {
+            sink(std::forward<Value>(value));
+        } else {
+            std::get<STAGE>(stages)(std::forward<Value>(value), [&](auto&& next) {
+                push<STAGE + 1>(std::forward<decltype(next)>(next), sink);
+            });
+        }
+    }
+
+    template <typename Iterator, typename Sentinel, typename Sink>
+    void run(Iterator first, Sentinel last, const Sink& sink) const {
+        for (; first != last; ++first) {
+            push<0>(*first, sink);
+        }
+    }
+};
+
+
+// The source is kept by reference, or copied when it is a view, so a
+// pipeline must not outlive a container it was built on.
+template <std::ranges::viewable_range Range>
+    requires std::copyable<std::views::all_t<Range>>
+auto pipe(Range&& range) {
+    auto source = std::views::all(std::forward<Range>(range));
+    auto view = source;
+
+    return Pipeline<decltype(source), decltype(view)>(std::move(source), std::move(view), std::tuple<>{});
+}
+
+}
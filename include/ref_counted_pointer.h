@@ -0,0 +1,214 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+
+// Shared owner of a T that lives in one allocation with its reference
+// count, unlike std::shared_ptr with a separate control block. Copies bump
+// the count with a relaxed increment; the acq-rel decrement that reaches
+// zero sees every write made through other owners before deleting. There
+// are no weak references or custom deleters.
+template <typename T>
+class RefCountedPointer {
+private:
+    struct Block {
+        std::atomic<std::size_t> references{1};
+        T value;
+
+        template <typename... Args>
+        explicit Block(Args&&... args) : value(std::forward<Args>(args)...) {}
+    };
+
+    Block* block = nullptr;
+
+    explicit RefCountedPointer(Block* block) : block(block) {}
+
+    void release() {
+        if (block != nullptr && block->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete block;
+        }
+    }
+
+    template <typename U, typename... Args>
+    friend RefCountedPointer<U> makeRefCounted(Args&&... args);
+
+    template <typename U>
+    friend class AtomicRefCountedPointer;
+
+public:
+    RefCountedPointer() = default;
+
+    RefCountedPointer(std::nullptr_t) {}
+
+    RefCountedPointer(const RefCountedPointer& other) : block(other.block) {
+        if (block != nullptr) {
+            block->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    RefCountedPointer(RefCountedPointer&& other) noexcept : block(std::exchange(other.block, nullptr)) {}
+
+    ~RefCountedPointer() {
+        release();
+    }
+
+    RefCountedPointer& operator=(const RefCountedPointer& other) {
+        RefCountedPointer copy{other};
+        std::swap(block, copy.block);
+        return *this;
+    }
+
+    RefCountedPointer& operator=(RefCountedPointer&& other) noexcept {
+        if (this != &other) {
+            release();
+            block = std::exchange(other.block, nullptr);
+        }
+
+        return *this;
+    }
+
+    T& operator*() const {
+        return block->value;
+    }
+
+    T* operator->() const {
+        return &block->value;
+    }
+
+    T* get() const {
+        return block == nullptr ? nullptr : &block->value;
+    }
+
+    // Only a hint while other threads copy or drop the same pointee.
+    std::size_t useCount() const {
+        return block == nullptr ? 0 : block->references.load(std::memory_order_relaxed);
+    }
+
+    bool isNull() const {
+        return block == nullptr;
+    }
+
+    explicit operator bool() const {
+        return block != nullptr;
+    }
+
+    friend bool operator==(const RefCountedPointer& left, const RefCountedPointer& right) {
+        return left.block == right.block;
+    }
+};
+
+
+template <typename T, typename... Args>
+RefCountedPointer<T> makeRefCounted(Args&&... args) {
+    return RefCountedPointer<T>(new typename RefCountedPointer<T>::Block(std::forward<Args>(args)...));
+}
+
+
+// Slot holding one RefCountedPointer that any number of threads may load
+// while others replace it, e.g. to publish a new graph snapshot to workers.
+//
+// The slot word packs the pointer into its low 48 bits and a count of
+// in-flight loads into the high 16. A load registers itself with a single
+// fetch_add, which pins the block because a writer cannot drop the slot's
+// reference without first seeing that count, then takes a reference of its
+// own and hands the registration back. A writer swaps the word and moves
+// the count of loads still in flight into the old block's reference count,
+// so each of those loads drops one reference there instead.
+//
+// Loads are lock-free, not wait-free: handing the registration back is a
+// compare-exchange that retries while other loads race on the slot word.
+template <typename T>
+class AtomicRefCountedPointer {
+private:
+    using Block = typename RefCountedPointer<T>::Block;
+
+    static constexpr int POINTER_BITS = 48;
+    static constexpr std::uint64_t POINTER_MASK = (std::uint64_t{1} << POINTER_BITS) - 1;
+    static constexpr std::uint64_t ONE_LOAD = std::uint64_t{1} << POINTER_BITS;
+
+    static_assert(sizeof(Block*) == sizeof(std::uint64_t), "the slot packs a 64-bit pointer");
+
+    std::atomic<std::uint64_t> word{0};
+
+    static std::uint64_t pack(Block* block) {
+        auto address = reinterpret_cast<std::uint64_t>(block);
+
+        if ((address & ~POINTER_MASK) != 0) {
+            throw std::runtime_error("AtomicRefCountedPointer: pointer does not fit in 48 bits");
+        }
+
+        return address;
+    }
+
+    static Block* blockOf(std::uint64_t word) {
+        return reinterpret_cast<Block*>(word & POINTER_MASK);
+    }
+
+    static std::uint64_t loadsOf(std::uint64_t word) {
+        return word >> POINTER_BITS;
+    }
+
+public:
+    AtomicRefCountedPointer() = default;
+
+    explicit AtomicRefCountedPointer(RefCountedPointer<T> pointer) {
+        word.store(pack(pointer.block), std::memory_order_relaxed);
+        pointer.block = nullptr;
+    }
+
+    AtomicRefCountedPointer(const AtomicRefCountedPointer&) = delete;
+    AtomicRefCountedPointer& operator=(const AtomicRefCountedPointer&) = delete;
+
+    ~AtomicRefCountedPointer() {
+        exchange(nullptr);
+    }
+
+    RefCountedPointer<T> load() {
+        auto registered = word.fetch_add(ONE_LOAD, std::memory_order_acquire);
+        auto block = blockOf(registered);
+
+        if (block != nullptr) {
+            block->references.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // While the slot still holds the block with loads in flight, one of
+        // them is ours to take back. Otherwise a writer has moved ours into
+        // the block's count, even if the same block was published again.
+        // Releasing here pairs with the acquire in a writer's exchange, so a
+        // writer that no longer sees our registration also sees the
+        // reference taken above before it can drop the last one.
+        auto current = word.load(std::memory_order_relaxed);
+        while (blockOf(current) == block && loadsOf(current) != 0) {
+            if (word.compare_exchange_weak(current, current - ONE_LOAD, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return RefCountedPointer<T>(block);
+            }
+        }
+
+        if (block != nullptr) {
+            // Cannot reach zero, the reference taken above is still held.
+            block->references.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        return RefCountedPointer<T>(block);
+    }
+
+    RefCountedPointer<T> exchange(RefCountedPointer<T> desired) {
+        auto previous = word.exchange(pack(desired.block), std::memory_order_acq_rel);
+        desired.block = nullptr;
+
+        auto block = blockOf(previous);
+        if (block != nullptr && loadsOf(previous) != 0) {
+            block->references.fetch_add(loadsOf(previous), std::memory_order_relaxed);
+        }
+
+        return RefCountedPointer<T>(block);
+    }
+
+    void store(RefCountedPointer<T> desired) {
+        exchange(std::move(desired));
+    }
+};
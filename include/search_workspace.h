@@ -0,0 +1,95 @@
+#pragma once
+
+#include "csr_graph.h"
+#include "indexed_heap.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+
+// Scratch buffers for one search at a time, sized to the largest graph seen.
+// reset() starts a new search by bumping an epoch instead of clearing, so a
+// vertex only counts as reached once it is stamped with the current epoch.
+template <typename E>
+class SearchWorkspace {
+public:
+    using VertexId = CsrGraph::VertexId;
+
+    std::vector<E> distances{};
+    std::vector<VertexId> links{};
+    std::vector<E> linkWeights{};
+    std::vector<VertexId> vertexQueue{};
+    IndexedDaryHeap<E> frontier{};
+
+    void reset(std::size_t vertexCount) {
+        if (stamps.size() < vertexCount) {
+            stamps.resize(vertexCount, 0);
+            distances.resize(vertexCount);
+            links.resize(vertexCount);
+            linkWeights.resize(vertexCount);
+            vertexQueue.resize(vertexCount);
+            frontier.resize(vertexCount);
+        }
+
+        frontier.clear();
+
+        if (++epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    bool reached(VertexId vertex) const {
+        return stamps[vertex] == epoch;
+    }
+
+    void reach(VertexId vertex, const E& distance) {
+        stamps[vertex] = epoch;
+        distances[vertex] = distance;
+    }
+
+private:
+    std::vector<std::uint32_t> stamps{};
+    std::uint32_t epoch = 0;
+};
+
+
+// The breadth-first counterpart: levels, parents and the queue, without
+// the heap and weight buffers a weighted search needs. Owned by the caller,
+// so its memory lives exactly as long as the caller keeps it.
+class LevelWorkspace {
+public:
+    using VertexId = CsrGraph::VertexId;
+
+    std::vector<std::uint32_t> levels{};
+    std::vector<VertexId> parents{};
+    std::vector<VertexId> vertexQueue{};
+
+    void reset(std::size_t vertexCount) {
+        if (stamps.size() < vertexCount) {
+            stamps.resize(vertexCount, 0);
+            levels.resize(vertexCount);
+            parents.resize(vertexCount);
+            vertexQueue.resize(vertexCount);
+        }
+
+        if (++epoch == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    bool reached(VertexId vertex) const {
+        return stamps[vertex] == epoch;
+    }
+
+    void reach(VertexId vertex, std::uint32_t level) {
+        stamps[vertex] = epoch;
+        levels[vertex] = level;
+    }
+
+private:
+    std::vector<std::uint32_t> stamps{};
+    std::uint32_t epoch = 0;
+};
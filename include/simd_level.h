@@ -0,0 +1,26 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_LEVEL_X86 1
+#endif
+
+
+enum class SimdLevel {
+    Scalar,
+    Sse41,
+    Avx2,
+};
+
+
+inline SimdLevel detectedSimdLevel() {
+#ifdef SIMD_LEVEL_X86
+    static const SimdLevel level = __builtin_cpu_supports("avx2")
+        ? SimdLevel::Avx2
+        : __builtin_cpu_supports("sse4.1") ? SimdLevel::Sse41 : SimdLevel::Scalar;
+
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+
+// Contiguous vector that keeps up to N elements inside the object. With
+// SPILLS a full vector moves to a heap buffer of twice the size, like
+// std::vector; without, pushing past N throws. Iterators are plain
+// pointers and are invalidated by anything that may reallocate, and by
+// moving a vector that has not spilled.
+template <typename T, std::size_t N, bool SPILLS>
+class InlineVector {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static_assert(N > 0, "InlineVector: inline capacity must be positive");
+
+    InlineVector() = default;
+
+    InlineVector(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+    }
+
+    template <std::input_iterator Iterator>
+    InlineVector(Iterator first, Iterator last) {
+        assign(first, last);
+    }
+
+    InlineVector(const InlineVector& other) {
+        assign(other.begin(), other.end());
+    }
+
+    InlineVector(InlineVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        takeFrom(other);
+    }
+
+    ~InlineVector() {
+        clear();
+        releaseHeap();
+    }
+
+    InlineVector& operator=(const InlineVector& other) {
+        if (this != &other) {
+            clear();
+            assign(other.begin(), other.end());
+        }
+
+        return *this;
+    }
+
+    InlineVector& operator=(InlineVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            releaseHeap();
+            takeFrom(other);
+        }
+
+        return *this;
+    }
+
+    T* data() {
+        return elements;
+    }
+
+    const T* data() const {
+        return elements;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    std::size_t capacity() const {
+        return room;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    bool isInline() const {
+        return elements == inlineElements();
+    }
+
+    T& operator[](std::size_t index) {
+        return elements[index];
+    }
+
+    const T& operator[](std::size_t index) const {
+        return elements[index];
+    }
+
+    T& front() {
+        return elements[0];
+    }
+
+    const T& front() const {
+        return elements[0];
+    }
+
+    T& back() {
+        return elements[count - 1];
+    }
+
+    const T& back() const {
+        return elements[count - 1];
+    }
+
+    iterator begin() {
+        return elements;
+    }
+
+    const_iterator begin() const {
+        return elements;
+    }
+
+    iterator end() {
+        return elements + count;
+    }
+
+    const_iterator end() const {
+        return elements + count;
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    void reserve(std::size_t capacity) {
+        if (capacity > room) {
+            grow(capacity);
+        }
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (count == room) {
+            // The arguments may refer into this vector, so build the new
+            // element before the old ones move.
+            T value(std::forward<Args>(args)...);
+            grow(room * 2);
+            return *new (elements + count++) T(std::move(value));
+        }
+
+        return *new (elements + count++) T(std::forward<Args>(args)...);
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() {
+        elements[--count].~T();
+    }
+
+    void resize(std::size_t size) {
+        reserve(size);
+
+        while (count < size) {
+            new (elements + count++) T();
+        }
+        while (count > size) {
+            pop_back();
+        }
+    }
+
+    void clear() {
+        std::destroy(elements, elements + count);
+        count = 0;
+    }
+
+    friend bool operator==(const InlineVector& left, const InlineVector& right) {
+        return std::equal(left.begin(), left.end(), right.begin(), right.end());
+    }
+
+private:
+    alignas(T) std::byte storage[N * sizeof(T)];
+    T* elements = inlineElements();
+    std::size_t count = 0;
+    std::size_t room = N;
+
+    T* inlineElements() {
+        return std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    const T* inlineElements() const {
+        return std::launder(reinterpret_cast<const T*>(storage));
+    }
+
+    template <typename Iterator>
+    void assign(Iterator first, Iterator last) {
+        if constexpr (std::forward_iterator<Iterator>) {
+            reserve(static_cast<std::size_t>(std::distance(first, last)));
+        }
+
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    void grow(std::size_t capacity) {
+        if constexpr (!SPILLS) {
+            throw std::length_error("StaticVector: capacity exceeded");
+        } else {
+            auto buffer = static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t{alignof(T)}));
+
+            try {
+                std::uninitialized_move(elements, elements + count, buffer);
+            } catch (...) {
+                ::operator delete(buffer, std::align_val_t{alignof(T)});
+                throw;
+            }
+
+            std::destroy(elements, elements + count);
+            releaseHeap();
+            elements = buffer;
+            room = capacity;
+        }
+    }
+
+    void releaseHeap() {
+        if (!isInline()) {
+            ::operator delete(elements, std::align_val_t{alignof(T)});
+            elements = inlineElements();
+            room = N;
+        }
+    }
+
+    // Expects this vector to be empty and inline.
+    void takeFrom(InlineVector& other) {
+        if (other.isInline()) {
+            std::uninitialized_move(other.begin(), other.end(), elements);
+            count = other.count;
+            other.clear();
+        } else {
+            elements = std::exchange(other.elements, other.inlineElements());
+            count = std::exchange(other.count, 0);
+            room = std::exchange(other.room, N);
+        }
+    }
+};
+
+
+// At most N elements, never allocates.
+template <typename T, std::size_t N>
+using StaticVector = InlineVector<T, N, false>;
+
+// N elements inline, then the heap.
+template <typename T, std::size_t N>
+using SmallVector = InlineVector<T, N, true>;
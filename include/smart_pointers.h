@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+// Every pointer below takes a deleter type, std::default_delete unless
+// given. It is stored with [[no_unique_address]], so a stateless deleter
+// such as ArenaDelete from arena.h adds nothing to the pointer's size.
+
+
+// Owns a T* and hands ownership over on copy, like the old std::auto_ptr.
+// The source of a copy is left null.
+template <typename T, typename Deleter = std::default_delete<T>>
+class AutoPointer {
+private:
+    T* pointer {};
+    [[no_unique_address]] Deleter deleter;
+
+    void destroy() {
+        if (pointer != nullptr) {
+            deleter(pointer);
+        }
+    }
+
+public:
+    AutoPointer(T* pointer = nullptr, Deleter deleter = Deleter())
+        : pointer(pointer), deleter(std::move(deleter))
+        {}
+
+    AutoPointer(AutoPointer& other) : deleter(other.deleter) {
+        pointer = other.pointer;
+        other.pointer = nullptr;
+    }
+
+    ~AutoPointer() {
+        destroy();
+    }
+
+    AutoPointer& operator=(AutoPointer& other) {
+        if (&other == this) {
+            return *this;
+        }
+
+        destroy();
+        pointer = other.pointer;
+        deleter = other.deleter;
+        other.pointer = nullptr;
+        return *this;
+    }
+
+    T& operator*() const {
+        return *pointer;
+    }
+    T* operator->() const {
+        return pointer;
+    }
+
+    bool isNull() const {
+        return pointer == nullptr;
+    }
+};
+
+
+// Move-only owner of a T*.
+template <typename T, typename Deleter = std::default_delete<T>>
+class RValueMove {
+private:
+    T* pointer;
+    [[no_unique_address]] Deleter deleter;
+
+    void destroy() {
+        if (pointer != nullptr) {
+            deleter(pointer);
+        }
+    }
+
+public:
+    RValueMove(T* pointer, Deleter deleter = Deleter()): pointer(pointer), deleter(std::move(deleter)) {}
+
+    RValueMove(RValueMove& right) = delete;
+
+    RValueMove(RValueMove&& right) noexcept : pointer(right.pointer), deleter(std::move(right.deleter)) {
+        right.pointer = nullptr;
+    }
+
+    ~RValueMove() {
+        destroy();
+    }
+
+    T& operator*() const {
+        return *pointer;
+    }
+
+    RValueMove& operator= (RValueMove& right) = delete;
+
+    RValueMove& operator= (RValueMove&& right) noexcept {
+        if (&right == this) {
+            return *this;
+        }
+
+        destroy();
+
+        pointer = right.pointer;
+        deleter = std::move(right.deleter);
+        right.pointer = nullptr;
+
+        return *this;
+    }
+
+    bool isNull() const {
+        return pointer == nullptr;
+    }
+};
+
+
+// Move-only owner parameterized on the pointer type itself, e.g.
+// CustomUniquePointer<std::string*>.
+template <typename T, typename Deleter = std::default_delete<std::remove_pointer_t<T>>>
+class CustomUniquePointer {
+private:
+    T pointer;
+    [[no_unique_address]] Deleter deleter;
+
+    void destroy() {
+        if (pointer != nullptr) {
+            deleter(pointer);
+        }
+    }
+
+public:
+    CustomUniquePointer(T pointer, Deleter deleter = Deleter()): pointer(pointer), deleter(std::move(deleter)) {}
+
+    CustomUniquePointer(CustomUniquePointer& customUniquePointer) = delete;
+
+    ~CustomUniquePointer() {
+        destroy();
+    }
+
+    CustomUniquePointer(CustomUniquePointer&& customUniquePointer) noexcept : deleter(std::move(customUniquePointer.deleter)) {
+        pointer = customUniquePointer.pointer;
+        customUniquePointer.pointer = nullptr;
+    }
+
+    CustomUniquePointer& operator= (CustomUniquePointer& right) = delete;
+
+    CustomUniquePointer& operator= (CustomUniquePointer&& right) noexcept {
+        if (this == &right) {
+            return *this;
+        }
+
+        destroy();
+
+        pointer = right.pointer;
+        deleter = std::move(right.deleter);
+        right.pointer = nullptr;
+
+        return *this;
+    }
+
+    auto& operator*() const {
+        return *pointer;
+    }
+
+    T get() const {
+        return pointer;
+    }
+
+    bool isNull() const {
+        return pointer == nullptr;
+    }
+};
+
+
+// Move-only owner of a T, taking the value type rather than a pointer type.
+// A T of at most INLINE_SIZE bytes that moves without throwing lives inside
+// the handle, so dereferencing it touches no other cache line; anything
+// bigger goes to the heap through a CustomUniquePointer. Moving an inline
+// value move-constructs it into the target, and either way the source is
+// left null.
+template <typename T, std::size_t INLINE_SIZE = 32>
+class InlineUniquePointer {
+public:
+    static constexpr bool STORES_INLINE = sizeof(T) <= INLINE_SIZE
+        && alignof(T) <= alignof(std::max_align_t)
+        && std::is_nothrow_move_constructible_v<T>;
+
+private:
+    struct InlineStorage {
+        alignas(T) std::byte bytes[sizeof(T)];
+        bool engaged = false;
+
+        InlineStorage() {}
+    };
+
+    using Storage = std::conditional_t<STORES_INLINE, InlineStorage, CustomUniquePointer<T*>>;
+
+    static Storage emptyStorage() {
+        if constexpr (STORES_INLINE) {
+            return InlineStorage{};
+        } else {
+            return CustomUniquePointer<T*>{nullptr};
+        }
+    }
+
+    Storage storage = emptyStorage();
+
+    // The held object, without checking that there is one.
+    T* object() const {
+        if constexpr (STORES_INLINE) {
+            return std::launder(reinterpret_cast<T*>(const_cast<std::byte*>(storage.bytes)));
+        } else {
+            return storage.get();
+        }
+    }
+
+    void takeFrom(InlineUniquePointer& other) noexcept {
+        if constexpr (STORES_INLINE) {
+            if (other.storage.engaged) {
+                new (storage.bytes) T(std::move(*other.object()));
+                storage.engaged = true;
+                other.reset();
+            }
+        } else {
+            storage = std::move(other.storage);
+        }
+    }
+
+public:
+    InlineUniquePointer() = default;
+
+    InlineUniquePointer(std::nullptr_t) {}
+
+    template <typename... Args>
+    explicit InlineUniquePointer(std::in_place_t, Args&&... args) {
+        if constexpr (STORES_INLINE) {
+            new (storage.bytes) T(std::forward<Args>(args)...);
+            storage.engaged = true;
+        } else {
+            storage = CustomUniquePointer<T*>{new T(std::forward<Args>(args)...)};
+        }
+    }
+
+    InlineUniquePointer(InlineUniquePointer& other) = delete;
+
+    InlineUniquePointer(InlineUniquePointer&& other) noexcept {
+        takeFrom(other);
+    }
+
+    ~InlineUniquePointer() {
+        reset();
+    }
+
+    InlineUniquePointer& operator= (InlineUniquePointer& right) = delete;
+
+    InlineUniquePointer& operator= (InlineUniquePointer&& right) noexcept {
+        if (this == &right) {
+            return *this;
+        }
+
+        reset();
+        takeFrom(right);
+
+        return *this;
+    }
+
+    void reset() {
+        if constexpr (STORES_INLINE) {
+            if (storage.engaged) {
+                object()->~T();
+                storage.engaged = false;
+            }
+        } else {
+            storage = CustomUniquePointer<T*>{nullptr};
+        }
+    }
+
+    T* get() const {
+        if constexpr (STORES_INLINE) {
+            return storage.engaged ? object() : nullptr;
+        } else {
+            return storage.get();
+        }
+    }
+
+    // Like std::unique_ptr, dereferencing does not check for an object, so
+    // the inline case reads the storage directly.
+    T& operator*() const {
+        return *object();
+    }
+
+    T* operator->() const {
+        return object();
+    }
+
+    bool isNull() const {
+        if constexpr (STORES_INLINE) {
+            return !storage.engaged;
+        } else {
+            return storage.get() == nullptr;
+        }
+    }
+};
+
+
+template <typename T, std::size_t INLINE_SIZE = 32, typename... Args>
+InlineUniquePointer<T, INLINE_SIZE> makeInlineUnique(Args&&... args) {
+    return InlineUniquePointer<T, INLINE_SIZE>(std::in_place, std::forward<Args>(args)...);
+}
@@ -0,0 +1,421 @@
+#pragma once
+
+#include "simd_level.h"
+#include "weight_filters.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// Strings stored back to back in one character buffer, Arrow style: string
+// i is characters[offsets[i], offsets[i + 1]). Offsets are 32-bit, so a
+// column holds at most 4 GiB of text. The buffer is followed by PADDING
+// bytes so kernels may read a whole vector from the start of any string.
+class StringColumn {
+public:
+    static constexpr std::size_t PADDING = 32;
+
+    StringColumn() : characters(PADDING), offsets{0} {}
+
+    // One pass over the strings, copying each into the buffer.
+    explicit StringColumn(std::span<const std::string> strings) : StringColumn() {
+        offsets.reserve(strings.size() + 1);
+
+        for (const auto& string : strings) {
+            push_back(string);
+        }
+    }
+
+    void push_back(std::string_view string) {
+        std::size_t begin = offsets.back();
+        std::size_t end = begin + string.size();
+
+        if (end > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("StringColumn: more than 4 GiB of text");
+        }
+
+        characters.resize(end + PADDING);
+        std::memcpy(characters.data() + begin, string.data(), string.size());
+        offsets.push_back(static_cast<std::uint32_t>(end));
+    }
+
+    std::string_view operator[](std::size_t index) const {
+        return {characters.data() + offsets[index], offsets[index + 1] - offsets[index]};
+    }
+
+    std::size_t size() const {
+        return offsets.size() - 1;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    const char* characterData() const {
+        return characters.data();
+    }
+
+    const std::uint32_t* offsetData() const {
+        return offsets.data();
+    }
+
+private:
+    std::vector<char> characters;
+    std::vector<std::uint32_t> offsets;
+};
+
+
+// An empty column has shortest = UINT32_MAX and longest = 0.
+struct LengthBounds {
+    std::uint32_t shortest;
+    std::uint32_t longest;
+
+    bool operator==(const LengthBounds&) const = default;
+};
+
+
+namespace string_kernels {
+
+inline void lengthsScalar(const std::uint32_t* offsets, std::size_t begin, std::size_t count, std::uint32_t* lengths) {
+    for (std::size_t i = begin; i < count; i++) {
+        lengths[i] = offsets[i + 1] - offsets[i];
+    }
+}
+
+inline LengthBounds boundsScalar(const std::uint32_t* offsets, std::size_t begin, std::size_t count, LengthBounds bounds) {
+    for (std::size_t i = begin; i < count; i++) {
+        auto length = offsets[i + 1] - offsets[i];
+        bounds.shortest = std::min(bounds.shortest, length);
+        bounds.longest = std::max(bounds.longest, length);
+    }
+    return bounds;
+}
+
+inline void selectLengthsScalar(
+    const std::uint32_t* offsets,
+    std::size_t begin,
+    std::size_t count,
+    std::uint32_t minimum,
+    std::uint32_t maximum,
+    std::uint64_t* mask
+) {
+    for (std::size_t i = begin; i < count; i++) {
+        auto length = offsets[i + 1] - offsets[i];
+        mask[i / 64] |= static_cast<std::uint64_t>(minimum <= length && length <= maximum) << (i % 64);
+    }
+}
+
+// Clears the bits of strings that differ from needle; set bits must
+// already have the needle's length.
+inline void keepEqualScalar(const char* characters, const std::uint32_t* offsets, std::string_view needle, std::uint64_t* mask, std::size_t words) {
+    for (std::size_t word = 0; word < words; word++) {
+        for (auto bits = mask[word]; bits != 0; bits &= bits - 1) {
+            auto i = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+
+            if (std::memcmp(characters + offsets[i], needle.data(), needle.size()) != 0) {
+                mask[word] &= ~(std::uint64_t{1} << (i % 64));
+            }
+        }
+    }
+}
+
+
+#ifdef SIMD_LEVEL_X86
+
+struct Avx2 {};
+struct Sse41 {};
+
+// The lengths of strings i to i + 7 are offsets[i + 1 ..] - offsets[i ..].
+__attribute__((target("avx2")))
+inline __m256i lengthBlock(const std::uint32_t* offsets, Avx2) {
+    auto starts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets));
+    auto ends = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + 1));
+    return _mm256_sub_epi32(ends, starts);
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i lengthBlock(const std::uint32_t* offsets, Sse41) {
+    auto starts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(offsets));
+    auto ends = _mm_loadu_si128(reinterpret_cast<const __m128i*>(offsets + 1));
+    return _mm_sub_epi32(ends, starts);
+}
+
+
+__attribute__((target("avx2")))
+inline void lengths(const std::uint32_t* offsets, std::size_t count, std::uint32_t* lengths, Avx2) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lengths + i), lengthBlock(offsets + i, Avx2{}));
+    }
+
+    lengthsScalar(offsets, i, count, lengths);
+}
+
+__attribute__((target("sse4.1")))
+inline void lengths(const std::uint32_t* offsets, std::size_t count, std::uint32_t* lengths, Sse41) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lengths + i), lengthBlock(offsets + i, Sse41{}));
+    }
+
+    lengthsScalar(offsets, i, count, lengths);
+}
+
+
+__attribute__((target("avx2")))
+inline LengthBounds bounds(const std::uint32_t* offsets, std::size_t count, Avx2) {
+    auto shortest = _mm256_set1_epi32(-1);
+    auto longest = _mm256_setzero_si256();
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto block = lengthBlock(offsets + i, Avx2{});
+        shortest = _mm256_min_epu32(shortest, block);
+        longest = _mm256_max_epu32(longest, block);
+    }
+
+    alignas(32) std::uint32_t shortestLanes[8];
+    alignas(32) std::uint32_t longestLanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(shortestLanes), shortest);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(longestLanes), longest);
+
+    return boundsScalar(offsets, i, count, {
+        *std::min_element(std::begin(shortestLanes), std::end(shortestLanes)),
+        *std::max_element(std::begin(longestLanes), std::end(longestLanes)),
+    });
+}
+
+__attribute__((target("sse4.1")))
+inline LengthBounds bounds(const std::uint32_t* offsets, std::size_t count, Sse41) {
+    auto shortest = _mm_set1_epi32(-1);
+    auto longest = _mm_setzero_si128();
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto block = lengthBlock(offsets + i, Sse41{});
+        shortest = _mm_min_epu32(shortest, block);
+        longest = _mm_max_epu32(longest, block);
+    }
+
+    alignas(16) std::uint32_t shortestLanes[4];
+    alignas(16) std::uint32_t longestLanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(shortestLanes), shortest);
+    _mm_store_si128(reinterpret_cast<__m128i*>(longestLanes), longest);
+
+    return boundsScalar(offsets, i, count, {
+        *std::min_element(std::begin(shortestLanes), std::end(shortestLanes)),
+        *std::max_element(std::begin(longestLanes), std::end(longestLanes)),
+    });
+}
+
+
+// Unsigned range checks: a length is inside when clamping it to
+// [minimum, maximum] leaves it unchanged.
+__attribute__((target("avx2")))
+inline void selectLengths(const std::uint32_t* offsets, std::size_t count, std::uint32_t minimum, std::uint32_t maximum, std::uint64_t* mask, Avx2) {
+    auto low = _mm256_set1_epi32(static_cast<int>(minimum));
+    auto high = _mm256_set1_epi32(static_cast<int>(maximum));
+    std::size_t whole = count / 64 * 64;
+
+    for (std::size_t i = 0; i < whole; i += 64) {
+        std::uint64_t word = 0;
+
+        for (std::size_t lane = 0; lane < 64; lane += 8) {
+            auto block = lengthBlock(offsets + i + lane, Avx2{});
+            auto clamped = _mm256_min_epu32(_mm256_max_epu32(block, low), high);
+            auto inside = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, clamped)));
+            word |= static_cast<std::uint64_t>(inside) << lane;
+        }
+
+        mask[i / 64] = word;
+    }
+
+    selectLengthsScalar(offsets, whole, count, minimum, maximum, mask);
+}
+
+__attribute__((target("sse4.1")))
+inline void selectLengths(const std::uint32_t* offsets, std::size_t count, std::uint32_t minimum, std::uint32_t maximum, std::uint64_t* mask, Sse41) {
+    auto low = _mm_set1_epi32(static_cast<int>(minimum));
+    auto high = _mm_set1_epi32(static_cast<int>(maximum));
+    std::size_t whole = count / 64 * 64;
+
+    for (std::size_t i = 0; i < whole; i += 64) {
+        std::uint64_t word = 0;
+
+        for (std::size_t lane = 0; lane < 64; lane += 4) {
+            auto block = lengthBlock(offsets + i + lane, Sse41{});
+            auto clamped = _mm_min_epu32(_mm_max_epu32(block, low), high);
+            auto inside = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, clamped)));
+            word |= static_cast<std::uint64_t>(inside) << lane;
+        }
+
+        mask[i / 64] = word;
+    }
+
+    selectLengthsScalar(offsets, whole, count, minimum, maximum, mask);
+}
+
+
+// Needles that fit in one vector are compared with a single load per
+// candidate, which the buffer padding keeps in bounds.
+__attribute__((target("avx2")))
+inline void keepEqual(const char* characters, const std::uint32_t* offsets, std::string_view needle, std::uint64_t* mask, std::size_t words, Avx2) {
+    if (needle.size() > 32) {
+        return keepEqualScalar(characters, offsets, needle, mask, words);
+    }
+
+    alignas(32) char padded[32]{};
+    std::memcpy(padded, needle.data(), needle.size());
+    auto pattern = _mm256_load_si256(reinterpret_cast<const __m256i*>(padded));
+    auto significant = static_cast<std::uint32_t>((std::uint64_t{1} << needle.size()) - 1);
+
+    for (std::size_t word = 0; word < words; word++) {
+        for (auto bits = mask[word]; bits != 0; bits &= bits - 1) {
+            auto i = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+            auto candidate = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(characters + offsets[i]));
+            auto equal = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(candidate, pattern)));
+
+            if ((equal & significant) != significant) {
+                mask[word] &= ~(std::uint64_t{1} << (i % 64));
+            }
+        }
+    }
+}
+
+__attribute__((target("sse4.1")))
+inline void keepEqual(const char* characters, const std::uint32_t* offsets, std::string_view needle, std::uint64_t* mask, std::size_t words, Sse41) {
+    if (needle.size() > 16) {
+        return keepEqualScalar(characters, offsets, needle, mask, words);
+    }
+
+    alignas(16) char padded[16]{};
+    std::memcpy(padded, needle.data(), needle.size());
+    auto pattern = _mm_load_si128(reinterpret_cast<const __m128i*>(padded));
+    auto significant = static_cast<std::uint32_t>((1u << needle.size()) - 1);
+
+    for (std::size_t word = 0; word < words; word++) {
+        for (auto bits = mask[word]; bits != 0; bits &= bits - 1) {
+            auto i = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+            auto candidate = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + offsets[i]));
+            auto equal = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(candidate, pattern)));
+
+            if ((equal & significant) != significant) {
+                mask[word] &= ~(std::uint64_t{1} << (i % 64));
+            }
+        }
+    }
+}
+
+#endif
+
+}
+
+
+inline std::vector<std::uint32_t> stringLengths(const StringColumn& column, SimdLevel level = detectedSimdLevel()) {
+    std::vector<std::uint32_t> lengths(column.size());
+
+#ifdef SIMD_LEVEL_X86
+    switch (level) {
+        case SimdLevel::Avx2:
+            string_kernels::lengths(column.offsetData(), column.size(), lengths.data(), string_kernels::Avx2{});
+            return lengths;
+        case SimdLevel::Sse41:
+            string_kernels::lengths(column.offsetData(), column.size(), lengths.data(), string_kernels::Sse41{});
+            return lengths;
+        case SimdLevel::Scalar:
+            break;
+    }
+#endif
+
+    (void)level;
+    string_kernels::lengthsScalar(column.offsetData(), 0, column.size(), lengths.data());
+    return lengths;
+}
+
+
+// The shortest and longest string lengths in one pass over the offsets.
+inline LengthBounds lengthBounds(const StringColumn& column, SimdLevel level = detectedSimdLevel()) {
+#ifdef SIMD_LEVEL_X86
+    switch (level) {
+        case SimdLevel::Avx2:
+            return string_kernels::bounds(column.offsetData(), column.size(), string_kernels::Avx2{});
+        case SimdLevel::Sse41:
+            return string_kernels::bounds(column.offsetData(), column.size(), string_kernels::Sse41{});
+        case SimdLevel::Scalar:
+            break;
+    }
+#endif
+
+    (void)level;
+    return string_kernels::boundsScalar(column.offsetData(), 0, column.size(), {std::numeric_limits<std::uint32_t>::max(), 0});
+}
+
+
+// Sets bit i of the mask when minimum <= length of string i <= maximum;
+// read it back with isSelected.
+inline void selectLengths(
+    const StringColumn& column,
+    std::uint32_t minimum,
+    std::uint32_t maximum,
+    std::vector<std::uint64_t>& mask,
+    SimdLevel level = detectedSimdLevel()
+) {
+    mask.assign((column.size() + 63) / 64, 0);
+
+    if (minimum > maximum) {
+        return;
+    }
+
+#ifdef SIMD_LEVEL_X86
+    switch (level) {
+        case SimdLevel::Avx2:
+            return string_kernels::selectLengths(column.offsetData(), column.size(), minimum, maximum, mask.data(), string_kernels::Avx2{});
+        case SimdLevel::Sse41:
+            return string_kernels::selectLengths(column.offsetData(), column.size(), minimum, maximum, mask.data(), string_kernels::Sse41{});
+        case SimdLevel::Scalar:
+            break;
+    }
+#endif
+
+    (void)level;
+    string_kernels::selectLengthsScalar(column.offsetData(), 0, column.size(), minimum, maximum, mask.data());
+}
+
+
+// Sets bit i of the mask when string i equals needle. Lengths are compared
+// first, so only strings of the needle's length have their text read.
+inline void selectEqual(
+    const StringColumn& column,
+    std::string_view needle,
+    std::vector<std::uint64_t>& mask,
+    SimdLevel level = detectedSimdLevel()
+) {
+    if (needle.size() > std::numeric_limits<std::uint32_t>::max()) {
+        return mask.assign((column.size() + 63) / 64, 0);
+    }
+
+    auto length = static_cast<std::uint32_t>(needle.size());
+    selectLengths(column, length, length, mask, level);
+
+#ifdef SIMD_LEVEL_X86
+    switch (level) {
+        case SimdLevel::Avx2:
+            return string_kernels::keepEqual(column.characterData(), column.offsetData(), needle, mask.data(), mask.size(), string_kernels::Avx2{});
+        case SimdLevel::Sse41:
+            return string_kernels::keepEqual(column.characterData(), column.offsetData(), needle, mask.data(), mask.size(), string_kernels::Sse41{});
+        case SimdLevel::Scalar:
+            break;
+    }
+#endif
+
+    string_kernels::keepEqualScalar(column.characterData(), column.offsetData(), needle, mask.data(), mask.size());
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// Fixed set of worker threads for fork-join loops. The calling thread works
+// on the tasks too, so a pool of N threads starts N - 1 workers.
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threadCount) {
+        for (std::size_t i = 1; i < threadCount; i++) {
+            workers.emplace_back([this] {
+                workerLoop();
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock{mutex};
+            stopping = true;
+        }
+
+        wake.notify_all();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    std::size_t threadCount() const {
+        return workers.size() + 1;
+    }
+
+    // Calls task(0) ... task(taskCount - 1) across the pool and returns once
+    // all of them have finished. Calls from several threads take turns. A
+    // call made from inside one of this pool's tasks runs its tasks inline
+    // on the calling thread instead of waiting on itself. If a task throws,
+    // no further tasks are started, the ones already running finish and the
+    // first exception is rethrown on the calling thread.
+    void run(std::size_t taskCount, const std::function<void(std::size_t)>& task) {
+        if (workers.empty() || taskCount <= 1 || runningPool == this) {
+            for (std::size_t i = 0; i < taskCount; i++) {
+                task(i);
+            }
+            return;
+        }
+
+        std::lock_guard turn{runMutex};
+        RunningPool running{this};
+
+        {
+            std::lock_guard lock{mutex};
+            currentTask = &task;
+            currentTaskCount = taskCount;
+            nextTask.store(0, std::memory_order_relaxed);
+            busyWorkers = workers.size();
+            generation++;
+        }
+
+        wake.notify_all();
+        drain(task, taskCount);
+
+        std::exception_ptr failure{};
+        {
+            std::unique_lock lock{mutex};
+            done.wait(lock, [this] {
+                return busyWorkers == 0;
+            });
+
+            currentTask = nullptr;
+            failure = std::exchange(firstFailure, nullptr);
+        }
+
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+private:
+    // The pool whose tasks the current thread is running, if any.
+    static inline thread_local const ThreadPool* runningPool = nullptr;
+
+    struct RunningPool {
+        const ThreadPool* previous;
+
+        explicit RunningPool(const ThreadPool* pool) : previous(runningPool) {
+            runningPool = pool;
+        }
+
+        ~RunningPool() {
+            runningPool = previous;
+        }
+    };
+
+    std::vector<std::thread> workers{};
+    std::mutex runMutex{};
+    std::mutex mutex{};
+    std::condition_variable wake{};
+    std::condition_variable done{};
+
+    const std::function<void(std::size_t)>* currentTask = nullptr;
+    std::size_t currentTaskCount = 0;
+    std::atomic<std::size_t> nextTask{0};
+    std::size_t busyWorkers = 0;
+    std::size_t generation = 0;
+    std::exception_ptr firstFailure{};
+    bool stopping = false;
+
+    // Never throws, so the caller always gets to wait for the workers
+    // before the task goes out of scope.
+    void drain(const std::function<void(std::size_t)>& task, std::size_t taskCount) {
+        for (auto i = nextTask.fetch_add(1); i < taskCount; i = nextTask.fetch_add(1)) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard lock{mutex};
+                if (!firstFailure) {
+                    firstFailure = std::current_exception();
+                }
+                nextTask.store(taskCount, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void workerLoop() {
+        RunningPool running{this};
+        std::size_t seenGeneration = 0;
+
+        while (true) {
+            std::unique_lock lock{mutex};
+            wake.wait(lock, [&] {
+                return stopping || generation != seenGeneration;
+            });
+
+            if (stopping) {
+                return;
+            }
+
+            seenGeneration = generation;
+            auto task = currentTask;
+            auto taskCount = currentTaskCount;
+            lock.unlock();
+
+            drain(*task, taskCount);
+
+            lock.lock();
+            if (--busyWorkers == 0) {
+                done.notify_one();
+            }
+        }
+    }
+};
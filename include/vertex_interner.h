@@ -0,0 +1,169 @@
+#pragma once
+
+#include "csr_graph.h"
+
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+template <typename V>
+class VertexInterner {
+public:
+    using VertexId = CsrGraph::VertexId;
+
+    VertexId intern(const V& vertex) {
+        auto [position, inserted] = ids.try_emplace(vertex, size());
+
+        if (inserted) {
+            labels.push_back(vertex);
+        }
+
+        return position->second;
+    }
+
+    std::optional<VertexId> find(const V& vertex) const {
+        auto position = ids.find(vertex);
+
+        if (position == ids.end()) {
+            return std::nullopt;
+        }
+
+        return position->second;
+    }
+
+    const V& labelOf(VertexId id) const {
+        return labels[id];
+    }
+
+    VertexId size() const {
+        return static_cast<VertexId>(labels.size());
+    }
+
+private:
+    std::unordered_map<V, VertexId> ids{};
+    std::vector<V> labels{};
+};
+
+
+// Flat arrays behind the string interner: packed label characters, the
+// offset where each label starts, label hashes and an open-addressing table
+// of ids. Nothing in them is a pointer, so they can be stored as they are.
+struct LabelTables {
+    using VertexId = CsrGraph::VertexId;
+
+    static constexpr VertexId NO_VERTEX = std::numeric_limits<VertexId>::max();
+
+    std::span<const char> characters{};
+    std::span<const std::size_t> labelOffsets{};
+    std::span<const std::size_t> hashes{};
+    std::span<const VertexId> slots{};
+
+    std::string_view labelOf(VertexId id) const {
+        return std::string_view(
+            characters.data() + labelOffsets[id],
+            labelOffsets[id + 1] - labelOffsets[id]
+        );
+    }
+
+    // Slot holding the label, or the empty slot where it would go.
+    std::size_t probe(std::string_view label, std::size_t hash) const {
+        const std::size_t mask = slots.size() - 1;
+
+        for (std::size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+            auto id = slots[slot];
+
+            if (id == NO_VERTEX || (hashes[id] == hash && labelOf(id) == label)) {
+                return slot;
+            }
+        }
+    }
+
+    std::optional<VertexId> find(std::string_view label) const {
+        auto id = slots[probe(label, std::hash<std::string_view>{}(label))];
+
+        if (id == NO_VERTEX) {
+            return std::nullopt;
+        }
+
+        return id;
+    }
+};
+
+
+// Labels are packed into one character buffer and looked up through an
+// open-addressing table of ids, so interning never allocates per label.
+// Views returned by labelOf are valid until the next intern call.
+template <>
+class VertexInterner<std::string> {
+public:
+    using VertexId = CsrGraph::VertexId;
+
+    VertexId intern(std::string_view label) {
+        auto hash = std::hash<std::string_view>{}(label);
+        auto slot = tables().probe(label, hash);
+
+        if (slots[slot] != NO_VERTEX) {
+            return slots[slot];
+        }
+
+        VertexId id = size();
+        characters.insert(characters.end(), label.begin(), label.end());
+        labelOffsets.push_back(characters.size());
+        hashes.push_back(hash);
+        slots[slot] = id;
+
+        if (static_cast<std::size_t>(size()) * 2 > slots.size()) {
+            grow();
+        }
+
+        return id;
+    }
+
+    std::optional<VertexId> find(std::string_view label) const {
+        return tables().find(label);
+    }
+
+    std::string_view labelOf(VertexId id) const {
+        return tables().labelOf(id);
+    }
+
+    VertexId size() const {
+        return static_cast<VertexId>(hashes.size());
+    }
+
+    LabelTables tables() const {
+        return LabelTables{characters, labelOffsets, hashes, slots};
+    }
+
+private:
+    static constexpr VertexId NO_VERTEX = LabelTables::NO_VERTEX;
+
+    std::vector<char> characters{};
+    std::vector<std::size_t> labelOffsets{0};
+    std::vector<std::size_t> hashes{};
+    std::vector<VertexId> slots = std::vector<VertexId>(16, NO_VERTEX);
+
+    void grow() {
+        std::vector<VertexId> grown(slots.size() * 2, NO_VERTEX);
+        const std::size_t mask = grown.size() - 1;
+
+        for (VertexId id = 0; id < size(); id++) {
+            auto slot = hashes[id] & mask;
+
+            while (grown[slot] != NO_VERTEX) {
+                slot = (slot + 1) & mask;
+            }
+
+            grown[slot] = id;
+        }
+
+        slots = std::move(grown);
+    }
+};
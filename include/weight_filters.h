@@ -0,0 +1,235 @@
+#pragma once
+
+#include "simd_level.h"
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+template <typename E>
+struct WeightAbove {
+    E threshold;
+
+    bool operator()(const E& weight) const {
+        return weight > threshold;
+    }
+
+    bool operator==(const WeightAbove&) const = default;
+};
+
+
+template <typename E>
+struct WeightBelow {
+    E threshold;
+
+    bool operator()(const E& weight) const {
+        return weight < threshold;
+    }
+
+    bool operator==(const WeightBelow&) const = default;
+};
+
+
+template <typename E>
+struct WeightBetween {
+    E low;
+    E high;
+
+    bool operator()(const E& weight) const {
+        return low <= weight && weight <= high;
+    }
+
+    bool operator==(const WeightBetween&) const = default;
+};
+
+
+template <typename Filter, typename E>
+concept WeightFilter =
+    std::same_as<Filter, WeightAbove<E>> ||
+    std::same_as<Filter, WeightBelow<E>> ||
+    std::same_as<Filter, WeightBetween<E>>;
+
+
+namespace weight_kernels {
+
+template <typename E, typename Filter>
+void selectScalar(const E* weights, std::size_t begin, std::size_t count, const Filter& filter, std::uint64_t* mask) {
+    for (std::size_t i = begin; i < count; i++) {
+        mask[i / 64] |= static_cast<std::uint64_t>(filter(weights[i])) << (i % 64);
+    }
+}
+
+
+#ifdef SIMD_LEVEL_X86
+
+struct Avx2 {};
+struct Sse41 {};
+
+__attribute__((target("avx2")))
+inline unsigned block(const std::int32_t* weights, const WeightAbove<std::int32_t>& filter, Avx2) {
+    auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights));
+    auto result = _mm256_cmpgt_epi32(values, _mm256_set1_epi32(filter.threshold));
+    return _mm256_movemask_ps(_mm256_castsi256_ps(result));
+}
+
+__attribute__((target("avx2")))
+inline unsigned block(const std::int32_t* weights, const WeightBelow<std::int32_t>& filter, Avx2) {
+    auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights));
+    auto result = _mm256_cmpgt_epi32(_mm256_set1_epi32(filter.threshold), values);
+    return _mm256_movemask_ps(_mm256_castsi256_ps(result));
+}
+
+__attribute__((target("avx2")))
+inline unsigned block(const std::int32_t* weights, const WeightBetween<std::int32_t>& filter, Avx2) {
+    auto values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights));
+    auto outside = _mm256_or_si256(
+        _mm256_cmpgt_epi32(_mm256_set1_epi32(filter.low), values),
+        _mm256_cmpgt_epi32(values, _mm256_set1_epi32(filter.high))
+    );
+    return ~_mm256_movemask_ps(_mm256_castsi256_ps(outside)) & 0xFFu;
+}
+
+__attribute__((target("avx2")))
+inline unsigned block(const float* weights, const WeightAbove<float>& filter, Avx2) {
+    return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(weights), _mm256_set1_ps(filter.threshold), _CMP_GT_OQ));
+}
+
+__attribute__((target("avx2")))
+inline unsigned block(const float* weights, const WeightBelow<float>& filter, Avx2) {
+    return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(weights), _mm256_set1_ps(filter.threshold), _CMP_LT_OQ));
+}
+
+__attribute__((target("avx2")))
+inline unsigned block(const float* weights, const WeightBetween<float>& filter, Avx2) {
+    auto values = _mm256_loadu_ps(weights);
+    auto inside = _mm256_and_ps(
+        _mm256_cmp_ps(values, _mm256_set1_ps(filter.low), _CMP_GE_OQ),
+        _mm256_cmp_ps(values, _mm256_set1_ps(filter.high), _CMP_LE_OQ)
+    );
+    return _mm256_movemask_ps(inside);
+}
+
+__attribute__((target("sse4.1")))
+inline unsigned block(const std::int32_t* weights, const WeightAbove<std::int32_t>& filter, Sse41) {
+    auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights));
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(values, _mm_set1_epi32(filter.threshold))));
+}
+
+__attribute__((target("sse4.1")))
+inline unsigned block(const std::int32_t* weights, const WeightBelow<std::int32_t>& filter, Sse41) {
+    auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights));
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(values, _mm_set1_epi32(filter.threshold))));
+}
+
+__attribute__((target("sse4.1")))
+inline unsigned block(const std::int32_t* weights, const WeightBetween<std::int32_t>& filter, Sse41) {
+    auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights));
+    auto outside = _mm_or_si128(
+        _mm_cmplt_epi32(values, _mm_set1_epi32(filter.low)),
+        _mm_cmpgt_epi32(values, _mm_set1_epi32(filter.high))
+    );
+    return ~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xFu;
+}
+
+__attribute__((target("sse4.1")))
+inline unsigned block(const float* weights, const WeightAbove<float>& filter, Sse41) {
+    return _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(weights), _mm_set1_ps(filter.threshold)));
+}
+
+__attribute__((target("sse4.1")))
+inline unsigned block(const float* weights, const WeightBelow<float>& filter, Sse41) {
+    return _mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(weights), _mm_set1_ps(filter.threshold)));
+}
+
+__attribute__((target("sse4.1")))
+inline unsigned block(const float* weights, const WeightBetween<float>& filter, Sse41) {
+    auto values = _mm_loadu_ps(weights);
+    auto inside = _mm_and_ps(
+        _mm_cmpge_ps(values, _mm_set1_ps(filter.low)),
+        _mm_cmple_ps(values, _mm_set1_ps(filter.high))
+    );
+    return _mm_movemask_ps(inside);
+}
+
+
+// Each 64-bit mask word is assembled from 64 / LANES vector compares.
+template <typename E, typename Filter>
+__attribute__((target("avx2")))
+void selectAvx2(const E* weights, std::size_t count, const Filter& filter, std::uint64_t* mask) {
+    std::size_t whole = count / 64 * 64;
+
+    for (std::size_t i = 0; i < whole; i += 64) {
+        std::uint64_t word = 0;
+
+        for (std::size_t lane = 0; lane < 64; lane += 8) {
+            word |= static_cast<std::uint64_t>(block(weights + i + lane, filter, Avx2{})) << lane;
+        }
+
+        mask[i / 64] = word;
+    }
+
+    selectScalar(weights, whole, count, filter, mask);
+}
+
+
+template <typename E, typename Filter>
+__attribute__((target("sse4.1")))
+void selectSse41(const E* weights, std::size_t count, const Filter& filter, std::uint64_t* mask) {
+    std::size_t whole = count / 64 * 64;
+
+    for (std::size_t i = 0; i < whole; i += 64) {
+        std::uint64_t word = 0;
+
+        for (std::size_t lane = 0; lane < 64; lane += 4) {
+            word |= static_cast<std::uint64_t>(block(weights + i + lane, filter, Sse41{})) << lane;
+        }
+
+        mask[i / 64] = word;
+    }
+
+    selectScalar(weights, whole, count, filter, mask);
+}
+
+#endif
+
+}
+
+
+template <typename E>
+concept SimdWeight = std::same_as<E, std::int32_t> || std::same_as<E, float>;
+
+
+// Sets bit i of the mask when weights[i] passes the filter. Int and float
+// weights with a comparison filter use the widest kernel the CPU supports.
+template <typename E, typename Filter>
+void selectWeights(
+    std::span<const E> weights,
+    const Filter& filter,
+    std::vector<std::uint64_t>& mask,
+    SimdLevel level = detectedSimdLevel()
+) {
+    mask.assign((weights.size() + 63) / 64, 0);
+
+#ifdef SIMD_LEVEL_X86
+    if constexpr (SimdWeight<E> && WeightFilter<Filter, E>) {
+        switch (level) {
+            case SimdLevel::Avx2:
+                return weight_kernels::selectAvx2(weights.data(), weights.size(), filter, mask.data());
+            case SimdLevel::Sse41:
+                return weight_kernels::selectSse41(weights.data(), weights.size(), filter, mask.data());
+            case SimdLevel::Scalar:
+                break;
+        }
+    }
+#endif
+
+    (void)level;
+    weight_kernels::selectScalar(weights.data(), 0, weights.size(), filter, mask.data());
+}
+
+
+inline bool isSelected(const std::vector<std::uint64_t>& mask, std::size_t index) {
+    return (mask[index / 64] >> (index % 64)) & 1u;
+}
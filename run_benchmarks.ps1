@@ -0,0 +1,26 @@
+if (-not (test-path "out")) { 
+	mkdir out
+}
+
+$benchmark_dir = "build\dependencies\benchmark\$(Get-ChildItem build/dependencies/benchmark)"
+
+g++ `
+	-O2 `
+	-Wall -Wextra -Werror `
+	-I include `
+	-I $benchmark_dir\include `
+	-L $benchmark_dir\build\src `
+	bench/bench.cpp `
+	-o out/bench.exe `
+	-l benchmark `
+	-l shlwapi `
+	-std=c++20
+	
+if ($?) {
+	if (-not (test-path "out/benchmarks")) {
+		mkdir out/benchmarks
+	}
+
+	$commit = git rev-parse --short HEAD
+	out/bench.exe --benchmark_out="out/benchmarks/$commit.json" --benchmark_out_format=json $args
+}
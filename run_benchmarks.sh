@@ -0,0 +1,22 @@
+#!/bin/sh
+# Builds the benchmarks in out/release and writes the results to
+# out/benchmarks/<commit>.json next to the console output. Compare two runs
+# with benchmark's tools/compare.py:
+#   compare.py benchmarks out/benchmarks/<old>.json out/benchmarks/<new>.json
+# Arguments are passed on, e.g. --benchmark_filter=BM_PathFinder.
+set -e
+
+mkdir -p out/benchmarks
+
+cmake -S . -B out/release -D CMAKE_BUILD_TYPE=Release
+cmake --build out/release --target bench -j "$(nproc)"
+
+commit=$(git rev-parse --short HEAD 2>/dev/null || echo local)
+if ! git diff --quiet HEAD 2>/dev/null; then
+	commit="$commit-dirty"
+fi
+
+out/release/bench \
+	--benchmark_out="out/benchmarks/$commit.json" \
+	--benchmark_out_format=json \
+	"$@"
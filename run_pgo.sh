@@ -0,0 +1,21 @@
+#!/bin/sh
+# Profile-guided build in two stages: an instrumented build runs the
+# benchmark suite to record profiles, then everything is rebuilt with them.
+# Arguments are passed to the training run, e.g. --benchmark_filter=BM_Parse
+# to train on part of the suite. The optimized binaries end up in out/pgo.
+set -e
+
+build=out/pgo
+profiles="$(pwd)/$build/profiles"
+
+rm -rf "$profiles"
+cmake -S . -B "$build" -D CMAKE_BUILD_TYPE=Release -D PGO=GENERATE -D PGO_PROFILE_DIR="$profiles"
+cmake --build "$build" --target bench -j "$(nproc)"
+"$build/bench" "$@"
+
+if command -v llvm-profdata >/dev/null && ls "$profiles"/*.profraw >/dev/null 2>&1; then
+	llvm-profdata merge -output="$profiles/default.profdata" "$profiles"/*.profraw
+fi
+
+cmake -S . -B "$build" -D PGO=USE
+cmake --build "$build" -j "$(nproc)"
@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "arena.h"
+#include "smart_pointers.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+struct CountedResource {
+    static inline int live = 0;
+
+    int x = 5;
+
+    CountedResource() {
+        live++;
+    }
+
+    ~CountedResource() {
+        live--;
+    }
+};
+
+
+TEST(ArenaTests, AllocationsAreAlignedAndDistinct) {
+    MonotonicArena arena{64};
+
+    auto small = arena.allocate(3, 1);
+    auto aligned = arena.allocate(8, 64);
+    auto large = arena.allocate(1000, 16);
+
+    ASSERT_NE(small, aligned);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0u);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(large) % 16, 0u);
+
+    auto text = arena.create<std::string>("in the arena");
+    ASSERT_EQ(*text, "in the arena");
+    text->~basic_string();
+}
+
+
+TEST(ArenaTests, ResetReusesChunks) {
+    MonotonicArena arena{1024};
+
+    auto first = arena.allocate(100);
+    for (int i = 0; i < 100; i++) {
+        arena.allocate(100);
+    }
+    auto capacity = arena.capacity();
+
+    arena.reset();
+
+    ASSERT_EQ(arena.allocate(100), first);
+    for (int i = 0; i < 100; i++) {
+        arena.allocate(100);
+    }
+    ASSERT_EQ(arena.capacity(), capacity);
+}
+
+
+TEST(ArenaTests, PoolRecyclesSlots) {
+    ObjectPool<CountedResource> pool{4};
+
+    auto first = pool.create();
+    auto second = pool.create();
+    ASSERT_EQ(CountedResource::live, 2);
+
+    pool.destroy(first);
+    ASSERT_EQ(CountedResource::live, 1);
+
+    std::vector<CountedResource*> created{pool.create(), second};
+    ASSERT_EQ(created[0], first);
+
+    for (int i = 0; i < 3; i++) {
+        created.push_back(pool.create());
+    }
+    ASSERT_EQ(pool.capacity(), 8u);
+    ASSERT_EQ(CountedResource::live, 5);
+
+    for (auto resource : created) {
+        pool.destroy(resource);
+    }
+    ASSERT_EQ(CountedResource::live, 0);
+}
+
+
+TEST(ArenaTests, SmartPointersTakeDeleters) {
+    MonotonicArena arena{};
+    ObjectPool<CountedResource> pool{};
+
+    static_assert(sizeof(RValueMove<CountedResource, ArenaDelete<CountedResource>>) == sizeof(CountedResource*));
+    static_assert(sizeof(CustomUniquePointer<CountedResource*>) == sizeof(CountedResource*));
+
+    {
+        RValueMove<CountedResource, ArenaDelete<CountedResource>> inArena{arena.create<CountedResource>()};
+        RValueMove<CountedResource, ArenaDelete<CountedResource>> moved{std::move(inArena)};
+
+        AutoPointer<CountedResource, PoolDelete<CountedResource>> inPool{pool.create(), PoolDelete{pool}};
+        AutoPointer<CountedResource, PoolDelete<CountedResource>> copied = inPool;
+
+        CustomUniquePointer<CountedResource*, PoolDelete<CountedResource>> unique{pool.create(), PoolDelete{pool}};
+        unique = CustomUniquePointer<CountedResource*, PoolDelete<CountedResource>>{pool.create(), PoolDelete{pool}};
+
+        ASSERT_TRUE(inArena.isNull());
+        ASSERT_TRUE(inPool.isNull());
+        ASSERT_EQ((*moved).x, 5);
+        ASSERT_EQ(copied->x, 5);
+        ASSERT_EQ(CountedResource::live, 3);
+    }
+
+    ASSERT_EQ(CountedResource::live, 0);
+
+    auto recycled = pool.create();
+    ASSERT_EQ(pool.capacity(), 1024u);
+    pool.destroy(recycled);
+}
@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include "smart_pointers.h"
+
 #include <initializer_list>
 #include <numeric>
 
@@ -209,46 +211,6 @@ TEST(ClassesTest, TestReferenceRemoval) {
 }
 
 
-template <typename T>
-class CustomUniquePointer {
-private:
-    T pointer;
-
-public:
-    CustomUniquePointer(T pointer): pointer(pointer) {}
-
-    CustomUniquePointer(CustomUniquePointer& customUniquePointer) = delete;
-
-    ~CustomUniquePointer() {
-        delete pointer;
-    }
-
-    CustomUniquePointer(CustomUniquePointer&& customUniquePointer) {
-        pointer = customUniquePointer.pointer;
-        customUniquePointer.pointer = nullptr;
-    }
-
-    CustomUniquePointer& operator= (CustomUniquePointer& right) = delete;
-
-    CustomUniquePointer& operator= (CustomUniquePointer&& right) {
-        if (this == &right) {
-            return *this;
-        }
-
-        delete pointer;
-
-        pointer = right.pointer;
-        right.pointer = nullptr;
-
-        return *this;
-    }
-
-    bool isNull() {
-        return pointer == nullptr;
-    }
-};
-
-
 int functionExpectingValue(CustomUniquePointer<std::string*> u1) {
     (void) u1;
     return 99;
@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "csr_graph.h"
+
+
+TEST(CsrGraphTests, GroupsNeighborsBySource) {
+    CsrGraph graph{4, {{2, 3}, {0, 1}, {2, 0}, {0, 2}}};
+
+    ASSERT_EQ(graph.vertexCount(), 4u);
+    ASSERT_EQ(graph.edgeCount(), 4u);
+
+    ASSERT_THAT(graph.neighborsOf(0), ::testing::ElementsAre(1, 2));
+    ASSERT_THAT(graph.neighborsOf(1), ::testing::IsEmpty());
+    ASSERT_THAT(graph.neighborsOf(2), ::testing::ElementsAre(3, 0));
+    ASSERT_THAT(graph.neighborsOf(3), ::testing::IsEmpty());
+}
+
+
+TEST(CsrGraphTests, WeightsFollowNeighbors) {
+    WeightedCsrGraph<int> graph{3, {{1, 2, 7}, {0, 2, 5}, {0, 1, 3}}};
+
+    ASSERT_THAT(graph.neighborsOf(0), ::testing::ElementsAre(2, 1));
+    ASSERT_THAT(graph.weightsOf(0), ::testing::ElementsAre(5, 3));
+    ASSERT_THAT(graph.neighborsOf(1), ::testing::ElementsAre(2));
+    ASSERT_THAT(graph.weightsOf(1), ::testing::ElementsAre(7));
+}
+
+
+TEST(CsrGraphTests, RejectsEdgesOutsideVertexRange) {
+    ASSERT_THROW((CsrGraph{2, {{0, 2}}}), std::out_of_range);
+    ASSERT_THAT(CsrGraph{}.vertexCount(), 0u);
+}
+
+
+TEST(CsrGraphTests, LazyEdgeViews) {
+    WeightedCsrGraph<int> graph{3, {{1, 2, 7}, {0, 2, 5}, {0, 1, 30}, {2, 0, 20}}};
+
+    static_assert(std::ranges::view<decltype(graph.edges())>);
+
+    std::vector<std::tuple<unsigned, unsigned, int>> heavy{};
+    for (const auto& edge : graph.edges() | std::views::filter([](const auto& edge) { return edge.weight > 6; })) {
+        heavy.push_back({edge.source, edge.target, edge.weight});
+    }
+
+    ASSERT_THAT(
+        heavy,
+        ::testing::ElementsAre(
+            std::tuple{0u, 1u, 30},
+            std::tuple{1u, 2u, 7},
+            std::tuple{2u, 0u, 20}
+        )
+    );
+    ASSERT_EQ(std::ranges::distance(graph.edgesOf(0)), 2);
+    ASSERT_EQ(&graph.edgesOf(0).front().weight, &graph.weightsOf(0)[0]);
+}
@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "dynamic_graph.h"
+
+
+TEST(DynamicGraphTests, StartsFromStaticLayout) {
+    DynamicCsrGraph graph{4, {{2, 3}, {0, 1}, {2, 0}, {0, 2}}};
+
+    ASSERT_EQ(graph.vertexCount(), 4u);
+    ASSERT_EQ(graph.edgeCount(), 4u);
+    ASSERT_THAT(graph.neighborsOf(0), ::testing::ElementsAre(1, 2));
+    ASSERT_THAT(graph.neighborsOf(2), ::testing::ElementsAre(3, 0));
+}
+
+
+TEST(DynamicGraphTests, InsertAndErase) {
+    DynamicCsrGraph graph{3, {{0, 1}}};
+
+    graph.insert(0, 2);
+    graph.insert(0, 2);
+    graph.insert(1, 0);
+
+    ASSERT_EQ(graph.edgeCount(), 4u);
+    ASSERT_THAT(graph.neighborsOf(0), ::testing::ElementsAre(1, 2, 2));
+    ASSERT_THAT(graph.neighborsOf(1), ::testing::ElementsAre(0));
+
+    ASSERT_TRUE(graph.erase(0, 1));
+    ASSERT_FALSE(graph.erase(0, 1));
+    ASSERT_FALSE(graph.erase(2, 0));
+    ASSERT_THAT(graph.neighborsOf(0), ::testing::ElementsAre(2, 2));
+    ASSERT_EQ(graph.edgeCount(), 3u);
+
+    ASSERT_THROW(graph.insert(0, 3), std::out_of_range);
+
+    graph.addVertices(4);
+    graph.insert(3, 0);
+    ASSERT_THAT(graph.neighborsOf(3), ::testing::ElementsAre(0));
+    ASSERT_THAT(graph.neighborsOf(0), ::testing::ElementsAre(2, 2));
+}
+
+
+TEST(DynamicGraphTests, CompactsAbandonedRows) {
+    DynamicCsrGraph graph{};
+    graph.addVertices(100);
+
+    for (int round = 0; round < 50; round++) {
+        for (DynamicCsrGraph::VertexId vertex = 0; vertex < 100; vertex++) {
+            graph.insert(vertex, (vertex + round) % 100);
+        }
+    }
+
+    ASSERT_GT(graph.compactions(), 0u);
+    ASSERT_EQ(graph.edgeCount(), 5000u);
+
+    for (DynamicCsrGraph::VertexId vertex = 0; vertex < 100; vertex++) {
+        auto row = graph.neighborsOf(vertex);
+        ASSERT_EQ(row.size(), 50u);
+        ASSERT_EQ(row[0], vertex);
+        ASSERT_EQ(row[49], (vertex + 49) % 100);
+    }
+}
+
+
+TEST(DynamicGraphTests, WeightsMoveWithTheirEdges) {
+    DynamicWeightedCsrGraph<int> graph{3, {{1, 2, 7}, {0, 2, 5}, {0, 1, 3}}};
+
+    for (int i = 0; i < 10; i++) {
+        graph.insert(0, 1, 10 + i);
+    }
+
+    ASSERT_EQ(graph.weightsOf(0).size(), 12u);
+    ASSERT_THAT(graph.weightsOf(0).first(3), ::testing::ElementsAre(5, 3, 10));
+
+    ASSERT_FALSE(graph.erase(0, 2, 6));
+    ASSERT_TRUE(graph.erase(0, 2, 5));
+    ASSERT_THAT(graph.neighborsOf(0).first(2), ::testing::ElementsAre(1, 1));
+    ASSERT_THAT(graph.weightsOf(0).first(2), ::testing::ElementsAre(19, 3));
+
+    for (const auto& edge : graph.edgesOf(0)) {
+        ASSERT_EQ(edge.target, 1u);
+        ASSERT_EQ(&edge.weight, &graph.allWeights()[edge.index]);
+    }
+    ASSERT_EQ(std::ranges::distance(graph.edges()), 12);
+}
@@ -0,0 +1,61 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "edge_list.h"
+
+#include <filesystem>
+#include <fstream>
+
+
+std::string writeEdgeList(const std::string& name, const std::string& contents) {
+    auto path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream output{path, std::ios::binary};
+    output << contents;
+    return path;
+}
+
+
+TEST(EdgeListTests, ReadsAcrossChunkBoundaries) {
+    auto path = writeEdgeList(
+        "edge_list_chunks.txt",
+        "# comment line\n"
+        "alpha beta 3\n"
+        "\n"
+        "  gamma\tdelta 12\r\n"
+        "a-label-longer-than-one-chunk b 7\n"
+        "last edge"
+    );
+
+    std::vector<std::tuple<std::string, std::string, std::string>> edges{};
+    EdgeListReader reader{path, 8};
+    auto statistics = reader.read([&](std::string_view from, std::string_view to, std::string_view weight) {
+        edges.push_back({std::string(from), std::string(to), std::string(weight)});
+    });
+
+    ASSERT_THAT(
+        edges,
+        ::testing::ElementsAre(
+            std::tuple{"alpha", "beta", "3"},
+            std::tuple{"gamma", "delta", "12"},
+            std::tuple{"a-label-longer-than-one-chunk", "b", "7"},
+            std::tuple{"last", "edge", ""}
+        )
+    );
+    ASSERT_EQ(statistics.edges, 4u);
+    ASSERT_EQ(statistics.bytes, std::filesystem::file_size(path));
+
+    std::filesystem::remove(path);
+}
+
+
+TEST(EdgeListTests, RejectsMalformedLines) {
+    auto path = writeEdgeList("edge_list_malformed.txt", "1 2 3\n4\n");
+
+    EdgeListReader reader{path};
+    ASSERT_THROW(reader.read([](auto, auto, auto) {}), std::runtime_error);
+    ASSERT_THROW(parseField<int>("12x"), std::runtime_error);
+    ASSERT_EQ(parseField<double>("2.5"), 2.5);
+    ASSERT_THROW(EdgeListReader{path + ".missing"}, std::runtime_error);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "graph_snapshot.h"
+
+#include <filesystem>
+#include <fstream>
+
+
+std::string snapshotPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+
+TEST(GraphSnapshotTests, MapsWrittenArrays) {
+    auto path = snapshotPath("graph_snapshot_arrays.bin");
+
+    VertexInterner<std::string> interner{};
+    for (auto label : {"a", "bb", "ccc"}) {
+        interner.intern(label);
+    }
+    WeightedCsrGraph<int> graph{3, {{0, 1, 5}, {1, 2, 7}, {0, 2, 9}}};
+
+    SnapshotWriter writer{path, 3, sizeof(int)};
+    writer.writeLabels(interner.tables());
+    writer.writeGraph(graph, SnapshotSection::Offsets, SnapshotSection::Neighbors);
+    writer.write(SnapshotSection::Weights, graph.allWeights());
+    writer.commit();
+
+    auto snapshot = std::make_shared<const GraphSnapshot>(path);
+    MappedVertexInterner labels{snapshot};
+    MappedWeightedCsrGraph<int> mapped{snapshot, SnapshotSection::Offsets, SnapshotSection::Neighbors, SnapshotSection::Weights};
+
+    ASSERT_EQ(labels.size(), 3u);
+    ASSERT_EQ(labels.find("bb"), std::optional<CsrGraph::VertexId>{1});
+    ASSERT_EQ(labels.find("dd"), std::nullopt);
+    ASSERT_EQ(labels.labelOf(2), "ccc");
+
+    ASSERT_EQ(mapped.vertexCount(), 3u);
+    ASSERT_THAT(mapped.neighborsOf(0), ::testing::ElementsAre(1, 2));
+    ASSERT_THAT(mapped.weightsOf(0), ::testing::ElementsAre(5, 9));
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(mapped.allNeighbors().data()) % SnapshotHeader::ALIGNMENT, 0u);
+
+    ASSERT_THROW(
+        (MappedWeightedCsrGraph<double>{snapshot, SnapshotSection::Offsets, SnapshotSection::Neighbors, SnapshotSection::Weights}),
+        std::runtime_error
+    );
+
+    std::filesystem::remove(path);
+}
+
+
+TEST(GraphSnapshotTests, RejectsOtherFiles) {
+    auto path = snapshotPath("graph_snapshot_garbage.bin");
+
+    {
+        std::ofstream output{path, std::ios::binary};
+        output << "definitely not a snapshot, but long enough to hold a header of some sort"
+               << std::string(256, 'x');
+    }
+
+    ASSERT_THROW(GraphSnapshot{path}, std::runtime_error);
+    ASSERT_THROW(GraphSnapshot{snapshotPath("graph_snapshot_missing.bin")}, std::system_error);
+
+    std::filesystem::remove(path);
+}
+
+
+TEST(GraphSnapshotTests, UncommittedWriterLeavesNoFile) {
+    auto path = snapshotPath("graph_snapshot_uncommitted.bin");
+
+    {
+        SnapshotWriter writer{path, 0, 0};
+    }
+
+    ASSERT_FALSE(std::filesystem::exists(path));
+    ASSERT_FALSE(std::filesystem::exists(path + ".partial"));
+}
@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "indexed_heap.h"
+
+#include <random>
+
+
+TEST(IndexedHeapTests, PopsInPriorityOrder) {
+    IndexedDaryHeap<int> heap{5};
+
+    heap.push(0, 50);
+    heap.push(1, 10);
+    heap.push(2, 30);
+    heap.push(3, 40);
+
+    heap.decrease(0, 5);
+    heap.pushOrDecrease(3, 20);
+    heap.pushOrDecrease(4, 25);
+
+    std::vector<unsigned> order{};
+    while (!heap.empty()) {
+        order.push_back(heap.pop());
+    }
+
+    ASSERT_THAT(order, ::testing::ElementsAre(0, 1, 3, 4, 2));
+    ASSERT_FALSE(heap.contains(0));
+}
+
+
+TEST(IndexedHeapTests, RejectsInvalidOperations) {
+    IndexedDaryHeap<int> heap{2};
+
+    heap.push(0, 10);
+
+    ASSERT_THROW(heap.push(0, 5), std::logic_error);
+    ASSERT_THROW(heap.decrease(0, 20), std::logic_error);
+}
+
+
+TEST(IndexedHeapTests, MatchesSortedOrderOnRandomInput) {
+    const unsigned count = 5000;
+    IndexedDaryHeap<int, 8> heap{count};
+    std::mt19937 random{42};
+    std::vector<int> priorities(count);
+
+    for (unsigned id = 0; id < count; id++) {
+        priorities[id] = static_cast<int>(random() % 100000);
+        heap.push(id, priorities[id]);
+    }
+    for (unsigned id = 0; id < count; id += 3) {
+        priorities[id] -= 500;
+        heap.decrease(id, priorities[id]);
+    }
+
+    std::sort(priorities.begin(), priorities.end());
+
+    for (auto expected : priorities) {
+        ASSERT_EQ(heap.priorityOf(heap.top()), expected);
+        heap.pop();
+    }
+}
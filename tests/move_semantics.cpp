@@ -1,48 +1,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
-
-template <typename T>
-class AutoPointer {
-private:
-    T* pointer {};
-
-public:
-    AutoPointer(T* pointer = nullptr) 
-        : pointer(pointer)
-        {}
-
-    AutoPointer(AutoPointer& other) {
-        pointer = other.pointer;
-        other.pointer = nullptr;        
-    }
-
-    ~AutoPointer() {
-        delete pointer;
-    }
-
-    AutoPointer& operator=(AutoPointer& other) {
-        if (&other == this) {
-            return *this;
-        }
-
-        delete pointer;
-        pointer = other.pointer;
-        other.pointer = nullptr;
-        return *this;
-    }
-
-    T& operator*() const { 
-        return *pointer;
-    }
-    T* operator->() const {
-        return pointer;
-    }
-
-    bool isNull() const {
-        return pointer == nullptr;
-    }
-};
+#include "smart_pointers.h"
 
 
 class Resource {
@@ -75,49 +34,6 @@ TEST(MoveSemantics, CustomAutoPointer) {
 }
 
 
-template <typename T>
-class RValueMove {
-private:
-    T* pointer;
-
-public:
-    RValueMove(T* pointer): pointer(pointer) {}
-
-    RValueMove(RValueMove& right) = delete;
-
-    RValueMove(RValueMove&& right) noexcept : pointer(right.pointer) {
-        right.pointer = nullptr;
-    }
-    
-    ~RValueMove() {
-        delete pointer;
-    }
-
-    T& operator*() const {
-        return *pointer;
-    }
-
-    RValueMove& operator= (RValueMove& right) = delete;
-
-    RValueMove& operator= (RValueMove&& right) noexcept {
-        if (&right = this) {
-            return *this;
-        }
-
-        delete pointer;
-
-        pointer = right.pointer;
-        right.pointer = nullptr;
-
-        return *this;
-    }
-
-    bool isNull() {
-        return pointer == nullptr;
-    }
-};
-
-
 RValueMove<Resource> generateResource() {
     RValueMove<Resource> r = { new Resource() };
     return r;
@@ -153,6 +69,20 @@ TEST(MoveSemantics, MyMove) {
 }
 
 
+TEST(MoveSemantics, MoveAssignment) {
+    RValueMove<Resource> r1 { generateResource() };
+    RValueMove<Resource> r2 { nullptr };
+
+    r2 = myMove(r1);
+    ASSERT_TRUE(r1.isNull());
+    ASSERT_EQ((*r2).x, 5);
+
+    auto& self = r2;
+    r2 = myMove(self);
+    ASSERT_FALSE(r2.isNull());
+}
+
+
 TEST(MoveSemantics, PlayingWithConversions) {
     double d { 3.5 };
 
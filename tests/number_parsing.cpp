@@ -0,0 +1,216 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "number_parsing.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+
+std::vector<int> streamNumbers(const std::string& text) {
+    std::istringstream stream(text);
+    return std::vector<int>(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+}
+
+
+TEST(NumberParsingTests, MatchesStreamExtraction) {
+    std::mt19937 random{107};
+    const char* separators[] = {" ", "  ", "\t", "\n", " \r\n", "\v", "\f"};
+    std::string text{};
+
+    for (int i = 0; i < 20000; i++) {
+        text += std::to_string(static_cast<int>(random()) >> (random() % 31));
+        text += separators[random() % std::size(separators)];
+    }
+    text += "+17 -0 2147483647 -2147483648";
+
+    auto expected = streamNumbers(text);
+
+    for (auto level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+        if (level > detectedSimdLevel()) {
+            continue;
+        }
+
+        std::vector<int> numbers{};
+        ASSERT_EQ(parseNumbers(std::string_view(text), numbers, level), text.size());
+        ASSERT_EQ(numbers, expected);
+    }
+}
+
+
+TEST(NumberParsingTests, StopsWhereStreamsStop) {
+    for (std::string text : {"1 2 x 3", "1 22abc 3", "4 2147483648 5", "  ", "7 - 8", "9 +-1"}) {
+        for (auto level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+            if (level > detectedSimdLevel()) {
+                continue;
+            }
+
+            // Long padding moves the failure into the block kernels.
+            auto padded = std::string(100, ' ') + text + std::string(100, ' ') + "10";
+            std::vector<int> numbers{};
+            parseNumbers(std::string_view(padded), numbers, level);
+
+            ASSERT_EQ(numbers, streamNumbers(padded)) << padded;
+        }
+    }
+
+    std::vector<int> numbers{};
+    ASSERT_EQ(parseNumbers(std::string_view("1 2 x 3"), numbers), 4u);
+}
+
+
+TEST(NumberParsingTests, StopsAtSignGluedToNumber) {
+    for (std::string text : {"12-5 7", "12+5 7"}) {
+        for (auto level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+            if (level > detectedSimdLevel()) {
+                continue;
+            }
+
+            auto padded = std::string(100, ' ') + text + std::string(100, ' ');
+            std::vector<int> numbers{};
+
+            // istream_iterator would go on with 5 and 7.
+            ASSERT_EQ(parseNumbers(std::string_view(padded), numbers, level), 102u) << text;
+            ASSERT_THAT(numbers, ::testing::ElementsAre(12));
+        }
+    }
+}
+
+
+TEST(NumberParsingTests, ReadsOneLineIntoExistingVector) {
+    std::stringstream stream;
+    stream << "2 1 5 3 4\n6 7\n";
+
+    std::vector<int> numbers{};
+    readNumbers(stream, numbers);
+    ASSERT_THAT(numbers, ::testing::ElementsAre(2, 1, 5, 3, 4));
+
+    auto data = numbers.data();
+    readNumbers(stream, numbers);
+    ASSERT_THAT(numbers, ::testing::ElementsAre(6, 7));
+    ASSERT_EQ(numbers.data(), data);
+}
+
+
+TEST(NumberParsingTests, ReadsLinesIntoCallerBuffer) {
+    std::stringstream stream;
+    stream << "10 20 30 40 50 60\n7\n";
+
+    std::vector<int> numbers{};
+    std::string buffer{};
+
+    readNumbers(stream, numbers, buffer);
+    ASSERT_THAT(numbers, ::testing::ElementsAre(10, 20, 30, 40, 50, 60));
+
+    auto capacity = buffer.capacity();
+    readNumbers(stream, numbers, buffer);
+    ASSERT_THAT(numbers, ::testing::ElementsAre(7));
+    ASSERT_EQ(buffer.capacity(), capacity);
+}
+
+
+TEST(NumberParsingTests, ReadsLinesLongerThanTheBuffer) {
+    std::mt19937 random{113};
+    std::string line{};
+
+    while (line.size() < (1 << 19)) {
+        line += std::to_string(static_cast<int>(random()) >> (random() % 31));
+        line.append(1 + random() % 3, ' ');
+    }
+
+    // Longer than a whole chunk.
+    std::string zeros(100000, '0');
+    auto longLine = line + zeros + "42 " + line;
+
+    std::stringstream stream;
+    stream << line << '\n' << longLine << '\n' << line << " x " << line << '\n' << "5" << '\n' << line;
+
+    std::vector<int> numbers{};
+    std::string buffer{};
+
+    readNumbers(stream, numbers, buffer);
+    ASSERT_EQ(numbers, streamNumbers(line));
+
+    readNumbers(stream, numbers, buffer);
+    ASSERT_EQ(numbers, streamNumbers(longLine));
+
+    readNumbers(stream, numbers, buffer);
+    ASSERT_EQ(numbers, streamNumbers(line));
+
+    readNumbers(stream, numbers, buffer);
+    ASSERT_THAT(numbers, ::testing::ElementsAre(5));
+
+    readNumbers(stream, numbers, buffer);
+    ASSERT_EQ(numbers, streamNumbers(line));
+    ASSERT_TRUE(stream.eof());
+    ASSERT_FALSE(stream.fail());
+
+    readNumbers(stream, numbers, buffer);
+    ASSERT_TRUE(numbers.empty());
+    ASSERT_TRUE(stream.fail());
+}
+
+
+std::string randomNumberText(std::size_t count, unsigned seed) {
+    std::mt19937 random{seed};
+    std::string text{};
+
+    for (std::size_t i = 0; i < count; i++) {
+        text += std::to_string(static_cast<int>(random()) >> (random() % 31));
+        text += i % 17 == 0 ? "\n" : " ";
+    }
+
+    return text;
+}
+
+
+TEST(NumberParsingTests, ParallelParseKeepsOrder) {
+    auto text = randomNumberText(200000, 113);
+    auto expected = streamNumbers(text);
+
+    for (std::size_t threads : {1, 3, 8}) {
+        ThreadPool pool{threads};
+        std::vector<int> numbers{-1};
+
+        ASSERT_EQ(parseNumbersInParallel(std::string_view(text), numbers, pool), text.size());
+        ASSERT_EQ(numbers.size(), expected.size() + 1);
+        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), numbers.begin() + 1));
+    }
+}
+
+
+TEST(NumberParsingTests, ParallelParseStopsAtFirstBadToken) {
+    auto text = randomNumberText(100000, 127);
+    auto broken = text.substr(0, text.size() / 3) + " oops " + text.substr(text.size() / 3);
+
+    ThreadPool pool{4};
+    std::vector<int> numbers{};
+    auto consumed = parseNumbersInParallel(std::string_view(broken), numbers, pool);
+
+    ASSERT_EQ(broken.substr(consumed, 4), "oops");
+    ASSERT_EQ(numbers, streamNumbers(broken));
+}
+
+
+TEST(NumberParsingTests, ParallelReadsFromStreamsAndFiles) {
+    auto text = randomNumberText(100000, 131);
+    auto expected = streamNumbers(text);
+    ThreadPool pool{4};
+
+    std::istringstream stream(text);
+    std::vector<int> streamed{};
+    readNumbersInParallel(stream, streamed, pool, 4096);
+    ASSERT_EQ(streamed, expected);
+
+    auto path = (std::filesystem::temp_directory_path() / "number_file.txt").string();
+    {
+        std::ofstream output{path, std::ios::binary};
+        output << text;
+    }
+    ASSERT_EQ(readNumberFile<int>(path, pool, SimdLevel::Scalar), expected);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "parallel_collections.h"
+
+#include <numeric>
+#include <random>
+
+
+std::vector<std::int32_t> randomInt32s(std::size_t count) {
+    std::mt19937 random{23};
+    std::vector<std::int32_t> values(count);
+
+    for (auto& value : values) {
+        value = static_cast<std::int32_t>(random()) >> (random() % 31 + 1);
+    }
+
+    return values;
+}
+
+
+const std::vector<SimdLevel> ALL_SIMD_LEVELS{SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2};
+
+
+TEST(ParallelCollectionsTests, GenericPipelinesMatchSerialAlgorithms) {
+    ThreadPool pool{4};
+    auto values = randomInt32s(300'001);
+    std::span<const std::int32_t> input{values};
+
+    std::vector<std::int64_t> doubled(values.size());
+    transformInParallel(input, std::span<std::int64_t>(doubled), [](std::int32_t x) { return std::int64_t{x} * 2; }, pool);
+    ASSERT_EQ(doubled[12345], std::int64_t{values[12345]} * 2);
+    ASSERT_EQ(doubled.back(), std::int64_t{values.back()} * 2);
+
+    auto total = reduceInParallel(input, std::int64_t{5}, std::plus<>{}, pool);
+    ASSERT_EQ(total, std::accumulate(values.begin(), values.end(), std::int64_t{5}));
+    ASSERT_EQ(reduceInParallel(std::span<const std::int32_t>{}, std::int64_t{5}, std::plus<>{}, pool), 5);
+
+    auto isEven = [](std::int32_t x) { return x % 2 == 0; };
+    std::vector<std::int32_t> expected{};
+    std::copy_if(values.begin(), values.end(), std::back_inserter(expected), isEven);
+    ASSERT_EQ(copyIfInParallel(input, isEven, pool), expected);
+}
+
+
+TEST(ParallelCollectionsTests, KernelsMatchScalarAtEveryLevel) {
+    for (std::size_t threads : {1, 3}) {
+        ThreadPool pool{threads};
+
+        for (std::size_t size : {0, 5, 17, 300'003}) {
+            auto values = randomInt32s(size);
+
+            std::vector<std::int32_t> odd{};
+            std::copy_if(values.begin(), values.end(), std::back_inserter(odd), [](std::int32_t x) { return x % 2 != 0; });
+            auto total = std::accumulate(values.begin(), values.end(), std::int64_t{0});
+
+            std::vector<float> floats(values.begin(), values.begin() + std::min<std::size_t>(size, 1000));
+            auto floatTotal = std::accumulate(floats.begin(), floats.end(), 0.0, [](double sum, float x) { return sum + x; });
+
+            for (auto level : ALL_SIMD_LEVELS) {
+                if (level != SimdLevel::Scalar && detectedSimdLevel() < level) {
+                    continue;
+                }
+
+                ASSERT_EQ(copyOddInParallel(values, pool, level), odd);
+                ASSERT_EQ(sumInParallel(std::span<const std::int32_t>(values), pool, level), total);
+                ASSERT_DOUBLE_EQ(sumInParallel(std::span<const float>(floats), pool, level), floatTotal);
+
+                auto incremented = values;
+                addOneInParallel(std::span<std::int32_t>(incremented), pool, level);
+                for (std::size_t i = 0; i < size; i++) {
+                    ASSERT_EQ(incremented[i], static_cast<std::int32_t>(static_cast<std::uint32_t>(values[i]) + 1));
+                }
+
+                auto incrementedFloats = floats;
+                addOneInParallel(std::span<float>(incrementedFloats), pool, level);
+                for (std::size_t i = 0; i < floats.size(); i++) {
+                    ASSERT_EQ(incrementedFloats[i], floats[i] + 1.0f);
+                }
+            }
+        }
+    }
+}
@@ -1,141 +1,828 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
-#include <map>
-#include <list>
-#include <queue>
+#include "edge_list.h"
+#include "pathfinder.h"
 
+#include <filesystem>
+#include <random>
+#include <thread>
 
-template<typename V, typename E>
-class PathFinder {
-public:
-    void add(const V vertex1, const V vertex2, const E edge) {
-        vertices.push_back(
-            {vertex1, vertex2, edge}
-        );
-    }
-    
-    std::vector<std::tuple<V, V, E>> find(const V& vertex1, const V& vertex2, const std::function<bool(E)>& filter) {
-        (void)vertex1;
-        (void)vertex2;
-        auto prefilteredVertices = prefilterVertices(filter);
 
-        return prefilteredVertices;
-    };
+TEST(PathFinderTests, Instantiate) {
+    PathFinder<std::string, int> pathfinder{};
 
-private:
-    std::vector<std::tuple<V, V, E>> vertices{}; 
+    ASSERT_THAT(&pathfinder, ::testing::NotNull());
+}
 
-    std::vector<std::tuple<V, V, E>> prefilterVertices(const std::function<bool(E)>& filter) {
-        std::vector<std::tuple<V, V, E>> prefilteredVertices{};
 
-        std::copy_if(
-            vertices.begin(),
-            vertices.end(),
-            std::back_inserter(prefilteredVertices),
-            [filter](std::tuple<V, V, E> input) {
-                auto edge = std::get<2>(input);
-                return filter(edge);
+TEST(PathFinderTests, AddVertices) {
+    PathFinder<std::string, int> pathfinder{};
+
+    pathfinder.add("hello", "goodbye", 2);
+    pathfinder.add("hello", "meowww", 30);
+
+    std::string text1 = "hello";
+    std::string text2 = "meowww";
+
+    ASSERT_THAT(
+        pathfinder.find(
+            text1,
+            text2,
+            [](int x) -> bool {
+                return x > 15;
             }
-        );
+        ),
+        ::testing::ElementsAre(
+            std::tuple{"hello", "meowww", 30}
+        )
+    );
+}
 
-        return prefilteredVertices;
-    }
-};
 
+TEST(PathFinderTests, FindCheapestPath) {
+    PathFinder<std::string, int> pathfinder{};
 
-template <typename V>
-class BreadthFirstSearch {
-public:
-    BreadthFirstSearch(const std::vector<std::pair<V, V>>& adjacentVertices) {
-        for (auto& adjacentPair : adjacentVertices) {
-            this->adjacencyMatrix[adjacentPair.first].push_back(adjacentPair.second);
-        }
+    pathfinder.add("a", "b", 20);
+    pathfinder.add("b", "d", 20);
+    pathfinder.add("a", "c", 16);
+    pathfinder.add("c", "d", 50);
+    pathfinder.add("a", "d", 100);
+    pathfinder.add("c", "b", 2);
+
+    auto all = [](int) -> bool {
+        return true;
+    };
+    auto heavy = [](int x) -> bool {
+        return x > 15;
+    };
+
+    ASSERT_THAT(
+        pathfinder.find("a", "d", all),
+        ::testing::ElementsAre(
+            std::tuple{"a", "c", 16},
+            std::tuple{"c", "b", 2},
+            std::tuple{"b", "d", 20}
+        )
+    );
+    ASSERT_THAT(
+        pathfinder.find("a", "d", heavy),
+        ::testing::ElementsAre(
+            std::tuple{"a", "b", 20},
+            std::tuple{"b", "d", 20}
+        )
+    );
+    ASSERT_THAT(pathfinder.find("d", "a", all), ::testing::IsEmpty());
+    ASSERT_THAT(pathfinder.find("a", "a", all), ::testing::IsEmpty());
+    ASSERT_THAT(pathfinder.find("a", "unknown", all), ::testing::IsEmpty());
+}
+
+
+TEST(PathFinderTests, FilteredEdgesView) {
+    PathFinder<std::string, int> pathfinder{};
+
+    pathfinder.add("hello", "goodbye", 2);
+    pathfinder.add("hello", "meowww", 30);
+    pathfinder.add("meowww", "goodbye", 16);
+
+    int total = 0;
+    std::size_t count = 0;
+    for (const auto& edge : pathfinder.filteredEdges([](int x) { return x > 15; })) {
+        total += edge.weight;
+        count++;
     }
 
-    std::vector<V> getShortestPathBetween(const V& vertex1, const V& vertex2) {
-        std::queue<std::vector<V>> vertexQueue{};
+    ASSERT_EQ(count, 2u);
+    ASSERT_EQ(total, 46);
+}
 
-        vertexQueue.push({vertex1});
 
-        while (!vertexQueue.empty()) {
-            auto path = vertexQueue.front();
-            auto lastVertex = path.back();
+TEST(PathFinderTests, AddVerticesAfterQuery) {
+    PathFinder<std::string, int> pathfinder{};
 
-            if (lastVertex == vertex2) {
-                return path;
-            }
+    pathfinder.add("hello", "meowww", 30);
+    auto filter = [](int x) -> bool {
+        return x > 15;
+    };
 
-            std::vector<V> adjacentVertices;
-            if (adjacencyMatrix.contains(lastVertex)) {
-                adjacentVertices = adjacencyMatrix[lastVertex];
-            } else {
-                adjacentVertices = std::vector<V>{};
-            }
+    ASSERT_THAT(pathfinder.find("hello", "goodbye", filter), ::testing::IsEmpty());
 
-            for (auto& adjacentVertex : adjacentVertices) {
-                std::vector<V> newPath{ path };
-                newPath.push_back(adjacentVertex);
-                
-                vertexQueue.push(newPath);
-            }
+    pathfinder.add("meowww", "hello", 20);
+    pathfinder.add("meowww", "goodbye", 2);
+    pathfinder.add("meowww", "goodbye", 40);
 
-            return adjacencyMatrix[vertex1];
+    ASSERT_THAT(
+        pathfinder.find("hello", "goodbye", filter),
+        ::testing::ElementsAre(
+            std::tuple{"hello", "meowww", 30},
+            std::tuple{"meowww", "goodbye", 40}
+        )
+    );
+}
+
+
+TEST(PathFinderTests, FindOnLargeGrid) {
+    const int width = 300;
+    PathFinder<int, int> pathfinder{};
+
+    for (int row = 0; row < width; row++) {
+        for (int column = 0; column < width; column++) {
+            int vertex = row * width + column;
+
+            if (column + 1 < width) {
+                pathfinder.add(vertex, vertex + 1, row == 0 ? 1 : 5);
+            }
+            if (row + 1 < width) {
+                pathfinder.add(vertex, vertex + width, column == width - 1 ? 1 : 5);
+            }
         }
+    }
+
+    auto path = pathfinder.find(0, width * width - 1, [](int) { return true; });
 
-        return std::vector<V>{};
+    ASSERT_THAT(path, ::testing::SizeIs(2 * (width - 1)));
+
+    int cost = 0;
+    for (auto& edge : path) {
+        cost += std::get<2>(edge);
     }
-    
 
-private:
-    std::map<V, std::vector<V>> adjacencyMatrix{};
+    ASSERT_EQ(cost, 2 * (width - 1));
+}
+
+
+TEST(PathFinderTests, InstantiateBFS) {
+    std::vector<std::pair<std::string, std::string>> ajdacentVertices {
+        {"1", "2"},
+        {"2", "3"},
+        {"3", "4"},
+    };
+
+    BreadthFirstSearch<std::string> bfs{ajdacentVertices};
+
+    ASSERT_THAT(
+        bfs.getShortestPathBetween("1", "4"),
+        ::testing::ElementsAre("1", "2", "3", "4")
+    );
+}
+
 
-};
+TEST(PathFinderTests, BFSMissingVertexHasNoPathToItself) {
+    std::vector<std::pair<std::string, std::string>> edges{{"1", "2"}, {"2", "3"}};
 
+    BreadthFirstSearch<std::string> serial{edges};
+    BreadthFirstSearch<std::string> parallel{edges, 2};
+    LevelWorkspace workspace{};
 
+    ASSERT_THAT(serial.getShortestPathBetween("9", "9"), ::testing::IsEmpty());
+    ASSERT_THAT(serial.getShortestPathBetween("9", "9", workspace), ::testing::IsEmpty());
+    ASSERT_THAT(parallel.getShortestPathBetween("9", "9"), ::testing::IsEmpty());
+    ASSERT_THAT(serial.getShortestPathBidirectional("9", "9"), ::testing::IsEmpty());
 
+    ASSERT_THAT(serial.getShortestPathBetween("2", "2"), ::testing::ElementsAre("2"));
+    ASSERT_THAT(parallel.getShortestPathBetween("2", "2"), ::testing::ElementsAre("2"));
+    ASSERT_THAT(serial.getShortestPathBidirectional("2", "2"), ::testing::ElementsAre("2"));
 
-TEST(PathFinderTests, Instantiate) {
+    auto batched = serial.getShortestPathsBetween({{"9", "9"}, {"2", "2"}});
+    ASSERT_THAT(batched[0], ::testing::IsEmpty());
+    ASSERT_THAT(batched[1], ::testing::ElementsAre("2"));
+}
+
+
+TEST(PathFinderTests, BFSPrefersShorterPath) {
+    std::vector<std::pair<std::string, std::string>> ajdacentVertices {
+        {"1", "2"},
+        {"2", "3"},
+        {"3", "4"},
+        {"1", "5"},
+        {"5", "4"},
+        {"4", "6"},
+    };
+
+    BreadthFirstSearch<std::string> bfs{ajdacentVertices};
+
+    ASSERT_THAT(
+        bfs.getShortestPathBetween("1", "4"),
+        ::testing::ElementsAre("1", "5", "4")
+    );
+    ASSERT_THAT(bfs.getShortestPathBetween("1", "1"), ::testing::ElementsAre("1"));
+    ASSERT_THAT(bfs.getShortestPathBetween("4", "1"), ::testing::IsEmpty());
+    ASSERT_THAT(bfs.getShortestPathBetween("1", "unknown"), ::testing::IsEmpty());
+}
+
+
+TEST(PathFinderTests, BFSLargeGrid) {
+    const int width = 500;
+    std::vector<std::pair<int, int>> ajdacentVertices{};
+
+    for (int row = 0; row < width; row++) {
+        for (int column = 0; column < width; column++) {
+            int vertex = row * width + column;
+
+            if (column + 1 < width) {
+                ajdacentVertices.push_back({vertex, vertex + 1});
+            }
+            if (row + 1 < width) {
+                ajdacentVertices.push_back({vertex, vertex + width});
+            }
+        }
+    }
+
+    BreadthFirstSearch<int> bfs{ajdacentVertices};
+
+    auto path = bfs.getShortestPathBetween(0, width * width - 1);
+
+    ASSERT_THAT(path, ::testing::SizeIs(2 * width - 1));
+    ASSERT_EQ(path.front(), 0);
+    ASSERT_EQ(path.back(), width * width - 1);
+
+    for (std::size_t i = 1; i < path.size(); i++) {
+        int step = path[i] - path[i - 1];
+        ASSERT_TRUE(step == 1 || step == width);
+    }
+}
+
+TEST(PathFinderTests, FindOverloadsAgree) {
     PathFinder<std::string, int> pathfinder{};
 
-    ASSERT_THAT(&pathfinder, ::testing::NotNull());
+    pathfinder.add("a", "b", 20);
+    pathfinder.add("b", "c", 20);
+    pathfinder.add("a", "c", 10);
+
+    std::function<bool(int)> erased = [](int x) { return x > 15; };
+
+    ASSERT_EQ(
+        pathfinder.find("a", "c", erased),
+        pathfinder.find("a", "c", [](int x) { return x > 15; })
+    );
+    ASSERT_THAT(pathfinder.find("a", "c", [](const int& x) { return x > 15; }), ::testing::SizeIs(2));
 }
 
 
-TEST(PathFinderTests, AddVertices) {
+TEST(PathFinderTests, FindWithWeightFilters) {
     PathFinder<std::string, int> pathfinder{};
 
-    pathfinder.add("hello", "goodbye", 2);
-    pathfinder.add("hello", "meowww", 30);
+    pathfinder.add("a", "b", 20);
+    pathfinder.add("b", "c", 20);
+    pathfinder.add("a", "c", 10);
 
-    std::string text1 = "hello";
+    ASSERT_THAT(pathfinder.find("a", "c", WeightAbove<int>{15}), ::testing::SizeIs(2));
+    ASSERT_THAT(pathfinder.find("a", "c", WeightBelow<int>{15}), ::testing::SizeIs(1));
+    ASSERT_THAT(pathfinder.find("a", "c", WeightBetween<int>{11, 19}), ::testing::IsEmpty());
+
+    pathfinder.add("b", "c", 12);
 
     ASSERT_THAT(
-        pathfinder.find(
-            text1,
-            text1,
-            [](int x) -> bool {
-                return x > 15;
-            }
-        ),
+        pathfinder.find("a", "c", WeightAbove<int>{11}),
         ::testing::ElementsAre(
-            std::tuple{"hello", "meowww", 30}
+            std::tuple{"a", "b", 20},
+            std::tuple{"b", "c", 12}
         )
     );
 }
 
 
-TEST(PathFinderTests, InstantiateBFS) {
+std::vector<std::pair<int, int>> randomEdges(int vertexCount, int edgeCount, unsigned seed) {
+    std::mt19937 random{seed};
+    std::vector<std::pair<int, int>> edges{};
+
+    for (int i = 0; i < edgeCount; i++) {
+        edges.push_back({
+            static_cast<int>(random() % vertexCount),
+            static_cast<int>(random() % vertexCount)
+        });
+    }
+
+    return edges;
+}
+
+
+TEST(PathFinderTests, ParallelBFSMatchesSerial) {
+    auto edges = randomEdges(20000, 200000, 17);
+
+    BreadthFirstSearch<int> serial{edges};
+    BreadthFirstSearch<int> parallel{edges, 4};
+
+    ASSERT_EQ(serial.threadCount(), 1u);
+    ASSERT_EQ(parallel.threadCount(), 4u);
+
+    std::mt19937 random{19};
+    for (int query = 0; query < 50; query++) {
+        int source = static_cast<int>(random() % 20000);
+        int target = static_cast<int>(random() % 20000);
+
+        ASSERT_EQ(
+            serial.getShortestPathBetween(source, target),
+            parallel.getShortestPathBetween(source, target)
+        );
+    }
+}
+
+
+TEST(PathFinderTests, ForwardOnlyBFSMatchesDefault) {
+    auto edges = randomEdges(5000, 25000, 37);
+
+    BreadthFirstSearch<int> withReverse{edges};
+    BreadthFirstSearch<int> forwardOnly{edges, 1, BfsAdjacency::ForwardOnly};
+    LevelWorkspace workspace{};
+
+    std::mt19937 random{41};
+    std::vector<std::pair<int, int>> queries{};
+
+    for (int query = 0; query < 100; query++) {
+        int source = static_cast<int>(random() % 20);
+        int target = static_cast<int>(random() % 5000);
+        queries.push_back({source, target});
+
+        ASSERT_EQ(
+            forwardOnly.getShortestPathBetween(source, target, workspace),
+            withReverse.getShortestPathBetween(source, target, workspace)
+        );
+    }
+
+    ASSERT_EQ(forwardOnly.getShortestPathsBetween(queries), withReverse.getShortestPathsBetween(queries));
+}
+
+
+TEST(PathFinderTests, ParallelBFSOnGrid) {
+    const int width = 200;
+    std::vector<std::pair<int, int>> ajdacentVertices{};
+
+    for (int vertex = 0; vertex < width * width; vertex++) {
+        if (vertex % width + 1 < width) {
+            ajdacentVertices.push_back({vertex, vertex + 1});
+        }
+        if (vertex + width < width * width) {
+            ajdacentVertices.push_back({vertex, vertex + width});
+        }
+    }
+
+    BreadthFirstSearch<int> serial{ajdacentVertices};
+    BreadthFirstSearch<int> parallel{ajdacentVertices, 3};
+
+    auto path = parallel.getShortestPathBetween(0, width * width - 1);
+
+    ASSERT_THAT(path, ::testing::SizeIs(2 * width - 1));
+    ASSERT_EQ(path, serial.getShortestPathBetween(0, width * width - 1));
+    ASSERT_THAT(parallel.getShortestPathBetween(width * width - 1, 0), ::testing::IsEmpty());
+}
+
+
+TEST(PathFinderTests, BidirectionalBFSFindsShortestPath) {
     std::vector<std::pair<std::string, std::string>> ajdacentVertices {
         {"1", "2"},
         {"2", "3"},
         {"3", "4"},
+        {"1", "5"},
+        {"5", "4"},
+        {"4", "6"},
     };
 
     BreadthFirstSearch<std::string> bfs{ajdacentVertices};
 
-    // ASSERT_THAT(
-    //     bfs.getShortestPathBetween("1", "4"),
-    //     ::testing::ElementsAre("1", "2", "3", "4")
-    // );
-}
\ No newline at end of file
+    ASSERT_THAT(bfs.getShortestPathBidirectional("1", "4"), ::testing::ElementsAre("1", "5", "4"));
+    ASSERT_THAT(bfs.getShortestPathBidirectional("2", "6"), ::testing::ElementsAre("2", "3", "4", "6"));
+    ASSERT_THAT(bfs.getShortestPathBidirectional("1", "2"), ::testing::ElementsAre("1", "2"));
+    ASSERT_THAT(bfs.getShortestPathBidirectional("1", "1"), ::testing::ElementsAre("1"));
+    ASSERT_THAT(bfs.getShortestPathBidirectional("4", "1"), ::testing::IsEmpty());
+}
+
+
+TEST(PathFinderTests, BidirectionalBFSExploresLess) {
+    auto edges = randomEdges(20000, 100000, 31);
+    BreadthFirstSearch<int> bfs{edges};
+
+    std::mt19937 random{37};
+    SearchStatistics forward{};
+    SearchStatistics bidirectional{};
+
+    for (int query = 0; query < 50; query++) {
+        int source = static_cast<int>(random() % 20000);
+        int target = static_cast<int>(random() % 20000);
+
+        auto expected = bfs.getShortestPathBetween(source, target, &forward);
+        auto path = bfs.getShortestPathBidirectional(source, target, &bidirectional);
+
+        ASSERT_EQ(path.size(), expected.size());
+        if (!path.empty()) {
+            ASSERT_EQ(path.front(), source);
+            ASSERT_EQ(path.back(), target);
+        }
+    }
+
+    ASSERT_LT(bidirectional.exploredVertices * 5, forward.exploredVertices);
+}
+
+
+TEST(PathFinderTests, BidirectionalDijkstraMatchesCost) {
+    std::mt19937 random{41};
+    PathFinder<int, int> pathfinder{};
+
+    for (int i = 0; i < 50000; i++) {
+        pathfinder.add(
+            static_cast<int>(random() % 5000),
+            static_cast<int>(random() % 5000),
+            static_cast<int>(random() % 100)
+        );
+    }
+
+    auto heavy = [](int x) { return x > 15; };
+    auto cost = [](const std::vector<std::tuple<int, int, int>>& path) {
+        int total = 0;
+        for (auto& edge : path) {
+            total += std::get<2>(edge);
+        }
+        return total;
+    };
+
+    SearchStatistics forward{};
+    SearchStatistics bidirectional{};
+
+    for (int query = 0; query < 30; query++) {
+        int source = static_cast<int>(random() % 5000);
+        int target = static_cast<int>(random() % 5000);
+
+        auto expected = pathfinder.find(source, target, heavy, &forward);
+        auto path = pathfinder.findBidirectional(source, target, heavy, &bidirectional);
+
+        ASSERT_EQ(cost(path), cost(expected));
+        ASSERT_EQ(path.empty(), expected.empty());
+
+        for (std::size_t i = 0; i < path.size(); i++) {
+            ASSERT_TRUE(heavy(std::get<2>(path[i])));
+            ASSERT_EQ(std::get<0>(path[i]), i == 0 ? source : std::get<1>(path[i - 1]));
+        }
+        if (!path.empty()) {
+            ASSERT_EQ(std::get<1>(path.back()), target);
+        }
+    }
+
+    ASSERT_LT(bidirectional.exploredVertices, forward.exploredVertices);
+}
+
+
+TEST(PathFinderTests, BatchedBFSMatchesSingleQueries) {
+    auto edges = randomEdges(5000, 25000, 43);
+
+    BreadthFirstSearch<int> serial{edges};
+    BreadthFirstSearch<int> parallel{edges, 3};
+
+    std::mt19937 random{47};
+    std::vector<std::pair<int, int>> queries{};
+
+    for (int i = 0; i < 300; i++) {
+        queries.push_back({static_cast<int>(random() % 20), static_cast<int>(random() % 5000)});
+    }
+    queries.push_back({7, 7});
+    queries.push_back({-1, 3});
+    queries.push_back(queries.front());
+
+    auto batched = serial.getShortestPathsBetween(queries);
+    auto batchedInParallel = parallel.getShortestPathsBetween(queries);
+
+    ASSERT_THAT(batched, ::testing::SizeIs(queries.size()));
+    ASSERT_EQ(batched, batchedInParallel);
+
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        ASSERT_EQ(batched[i], serial.getShortestPathBetween(queries[i].first, queries[i].second)) << "query " << i;
+    }
+
+    ASSERT_THAT(serial.getShortestPathsBetween({}), ::testing::IsEmpty());
+}
+
+
+TEST(PathFinderTests, BFSWithSharedWorkspace) {
+    auto small = randomEdges(100, 400, 59);
+    auto large = randomEdges(3000, 12000, 61);
+
+    BreadthFirstSearch<int> smallBfs{small};
+    BreadthFirstSearch<int> largeBfs{large};
+    LevelWorkspace workspace{};
+
+    std::mt19937 random{67};
+    for (int query = 0; query < 100; query++) {
+        auto& bfs = query % 2 == 0 ? smallBfs : largeBfs;
+        int vertexCount = query % 2 == 0 ? 100 : 3000;
+        int source = static_cast<int>(random() % vertexCount);
+        int target = static_cast<int>(random() % vertexCount);
+
+        ASSERT_EQ(
+            bfs.getShortestPathBetween(source, target, workspace),
+            bfs.getShortestPathBetween(source, target)
+        );
+    }
+}
+
+
+TEST(PathFinderTests, FindWithCallerWorkspaces) {
+    PathFinder<int, int> pathfinder{};
+    std::mt19937 random{79};
+
+    for (int i = 0; i < 8000; i++) {
+        pathfinder.add(static_cast<int>(random() % 1000), static_cast<int>(random() % 1000), static_cast<int>(random() % 50));
+    }
+
+    auto filter = [](int x) { return x > 10; };
+    std::vector<std::pair<int, int>> queries{};
+    std::vector<std::vector<std::tuple<int, int, int>>> expected{};
+
+    for (int query = 0; query < 40; query++) {
+        queries.push_back({static_cast<int>(random() % 1000), static_cast<int>(random() % 1000)});
+        expected.push_back(pathfinder.find(queries.back().first, queries.back().second, filter));
+    }
+
+    // With the edges merged and a predicate filter, queries only read the
+    // instance, so threads with their own workspaces can share it.
+    std::vector<std::thread> threads{};
+    std::vector<int> mismatches(4, 0);
+
+    for (std::size_t thread = 0; thread < mismatches.size(); thread++) {
+        threads.emplace_back([&, thread] {
+            SearchWorkspace<int> workspace{};
+
+            for (std::size_t query = 0; query < queries.size(); query++) {
+                auto path = pathfinder.find(queries[query].first, queries[query].second, filter, workspace);
+                mismatches[thread] += path != expected[query];
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_THAT(mismatches, ::testing::Each(0));
+}
+
+
+TEST(PathFinderTests, DynamicBFSMatchesRebuilt) {
+    auto edges = randomEdges(2000, 6000, 71);
+    auto initial = std::vector<std::pair<int, int>>(edges.begin(), edges.begin() + 3000);
+
+    BreadthFirstSearch<int, DynamicCsrGraph> dynamic{initial};
+
+    for (std::size_t i = 3000; i < edges.size(); i++) {
+        dynamic.addEdge(edges[i].first, edges[i].second);
+    }
+    for (std::size_t i = 0; i < edges.size(); i += 3) {
+        ASSERT_TRUE(dynamic.removeEdge(edges[i].first, edges[i].second));
+    }
+    ASSERT_FALSE(dynamic.removeEdge(-1, 0));
+
+    std::vector<std::pair<int, int>> remaining{};
+    for (std::size_t i = 0; i < edges.size(); i++) {
+        if (i % 3 != 0) {
+            remaining.push_back(edges[i]);
+        }
+    }
+    BreadthFirstSearch<int> rebuilt{remaining};
+
+    std::mt19937 random{73};
+    for (int query = 0; query < 50; query++) {
+        int source = static_cast<int>(random() % 2000);
+        int target = static_cast<int>(random() % 2000);
+
+        ASSERT_EQ(dynamic.getShortestPathBetween(source, target).size(), rebuilt.getShortestPathBetween(source, target).size());
+        ASSERT_EQ(dynamic.getShortestPathBidirectional(source, target).size(), rebuilt.getShortestPathBetween(source, target).size());
+    }
+}
+
+
+TEST(PathFinderTests, GraphKindsAreDetectedAlike) {
+    static_assert(DynamicGraph<DynamicCsrGraph> && DynamicGraph<DynamicWeightedCsrGraph<int>>);
+    static_assert(MappedGraph<MappedCsrGraph> && MappedGraph<MappedWeightedCsrGraph<int>>);
+    static_assert(!DynamicGraph<CsrGraph> && !MappedGraph<WeightedCsrGraph<int>>);
+
+    static_assert(PathFinder<int, int, DynamicWeightedCsrGraph<int>>::DYNAMIC);
+    static_assert(BreadthFirstSearch<int, DynamicCsrGraph>::DYNAMIC);
+    static_assert(BreadthFirstSearch<std::string, MappedCsrGraph>::MAPPED);
+    static_assert(!BreadthFirstSearch<int>::DYNAMIC && !BreadthFirstSearch<int>::MAPPED);
+}
+
+
+TEST(PathFinderTests, DynamicPathFinderKeepsSelectionCurrent) {
+    std::mt19937 random{79};
+    PathFinder<int, int, DynamicWeightedCsrGraph<int>> pathfinder{};
+    std::vector<std::tuple<int, int, int>> added{};
+
+    auto cost = [](const std::vector<std::tuple<int, int, int>>& path) {
+        int total = 0;
+        for (auto& edge : path) {
+            total += std::get<2>(edge);
+        }
+        return total;
+    };
+
+    for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < 500; i++) {
+            added.push_back({
+                static_cast<int>(random() % 1000),
+                static_cast<int>(random() % 1000),
+                static_cast<int>(random() % 100)
+            });
+            pathfinder.add(std::get<0>(added.back()), std::get<1>(added.back()), std::get<2>(added.back()));
+        }
+        for (int i = 0; i < 100; i++) {
+            auto [from, to, weight] = added[random() % added.size()];
+            pathfinder.remove(from, to, weight);
+        }
+
+        int source = static_cast<int>(random() % 1000);
+        int target = static_cast<int>(random() % 1000);
+        auto expected = pathfinder.find(source, target, std::function<bool(int)>([](int x) { return x > 30; }));
+
+        ASSERT_EQ(cost(pathfinder.find(source, target, WeightAbove<int>{30})), cost(expected));
+        ASSERT_EQ(cost(pathfinder.findBidirectional(source, target, WeightAbove<int>{30})), cost(expected));
+    }
+
+    ASSERT_FALSE(pathfinder.remove(-1, 0, 0));
+}
+
+
+TEST(PathFinderTests, BFSSnapshotRoundTrip) {
+    auto path = (std::filesystem::temp_directory_path() / "bfs_snapshot.bin").string();
+
+    std::vector<std::pair<std::string, std::string>> edges{};
+    for (auto [from, to] : randomEdges(3000, 12000, 83)) {
+        edges.push_back({"v" + std::to_string(from), "v" + std::to_string(to)});
+    }
+
+    BreadthFirstSearch<std::string> built{edges};
+    built.save(path);
+
+    auto mapped = BreadthFirstSearch<std::string, MappedCsrGraph>::load(path);
+    auto parallel = BreadthFirstSearch<std::string, MappedCsrGraph>::load(path, 4);
+    ASSERT_THROW((PathFinder<std::string, int, MappedWeightedCsrGraph<int>>::load(path)), std::runtime_error);
+
+    std::mt19937 random{89};
+    for (int query = 0; query < 50; query++) {
+        auto source = "v" + std::to_string(random() % 3000);
+        auto target = "v" + std::to_string(random() % 3000);
+        auto expected = built.getShortestPathBetween(source, target);
+
+        ASSERT_EQ(mapped.getShortestPathBetween(source, target), expected);
+        ASSERT_EQ(parallel.getShortestPathBetween(source, target), expected);
+        ASSERT_EQ(mapped.getShortestPathBidirectional(source, target).size(), expected.size());
+    }
+    ASSERT_THAT(mapped.getShortestPathBetween("v1", "nowhere"), ::testing::IsEmpty());
+
+    std::filesystem::remove(path);
+}
+
+
+TEST(PathFinderTests, PathFinderSnapshotRoundTrip) {
+    auto path = (std::filesystem::temp_directory_path() / "pathfinder_snapshot.bin").string();
+
+    std::mt19937 random{97};
+    PathFinder<std::string, int> built{};
+    for (int i = 0; i < 20000; i++) {
+        built.add(
+            "v" + std::to_string(random() % 2000),
+            "v" + std::to_string(random() % 2000),
+            static_cast<int>(random() % 100)
+        );
+    }
+    built.save(path);
+
+    auto mapped = PathFinder<std::string, int, MappedWeightedCsrGraph<int>>::load(path);
+
+    for (int query = 0; query < 30; query++) {
+        auto source = "v" + std::to_string(random() % 2000);
+        auto target = "v" + std::to_string(random() % 2000);
+        auto expected = built.find(source, target, [](int x) { return x > 20; });
+
+        ASSERT_EQ(mapped.find(source, target, [](int x) { return x > 20; }), expected);
+        ASSERT_EQ(mapped.find(source, target, WeightAbove<int>{20}), expected);
+        ASSERT_EQ(mapped.findBidirectional(source, target, WeightAbove<int>{20}).size() == 0, expected.empty());
+    }
+
+    std::filesystem::remove(path);
+}
+
+
+TEST(PathFinderTests, IngestEdgeListMatchesAdd) {
+    auto path = (std::filesystem::temp_directory_path() / "pathfinder_edges.txt").string();
+
+    std::mt19937 random{101};
+    PathFinder<int, int> added{};
+    {
+        std::ofstream output{path};
+        for (int i = 0; i < 20000; i++) {
+            int from = static_cast<int>(random() % 2000);
+            int to = static_cast<int>(random() % 2000);
+            int weight = static_cast<int>(random() % 100);
+
+            output << from << ' ' << to << ' ' << weight << '\n';
+            added.add(from, to, weight);
+        }
+    }
+
+    PathFinder<int, int> ingested{};
+    auto statistics = ingestEdgeList<int, int>(path, ingested, 4096);
+    ASSERT_EQ(statistics.edges, 20000u);
+    ASSERT_GE(statistics.megabytesPerSecond(), 0);
+
+    for (int query = 0; query < 30; query++) {
+        int source = static_cast<int>(random() % 2000);
+        int target = static_cast<int>(random() % 2000);
+
+        ASSERT_EQ(ingested.find(source, target, WeightAbove<int>{20}), added.find(source, target, WeightAbove<int>{20}));
+    }
+
+    std::filesystem::remove(path);
+}
+
+
+TEST(PathFinderTests, ExternalSnapshotBuildMatchesSave) {
+    auto directory = std::filesystem::temp_directory_path();
+    auto edgesPath = (directory / "external_edges.txt").string();
+    auto builtPath = (directory / "external_built.bin").string();
+    auto savedPath = (directory / "external_saved.bin").string();
+
+    std::mt19937 random{103};
+    PathFinder<std::string, int> added{};
+    std::vector<std::pair<std::string, std::string>> pairs{};
+    {
+        std::ofstream output{edgesPath};
+        for (int i = 0; i < 10000; i++) {
+            auto from = "v" + std::to_string(random() % 1500);
+            auto to = "v" + std::to_string(random() % 1500);
+            int weight = static_cast<int>(random() % 100);
+
+            output << from << '\t' << to << '\t' << weight << '\n';
+            added.add(from, to, weight);
+            pairs.push_back({from, to});
+        }
+    }
+    added.save(savedPath);
+
+    SnapshotBuilder<int> builder{SnapshotBuildOptions{.memoryBudget = 12 * 1000, .chunkSize = 1024}};
+    auto statistics = builder.build(edgesPath, builtPath);
+    ASSERT_EQ(statistics.edges, 10000u);
+    ASSERT_GT(builder.runCount(), 1u);
+
+    auto read = [](const std::string& path) {
+        std::ifstream input{path, std::ios::binary};
+        return std::string(std::istreambuf_iterator<char>(input), {});
+    };
+    ASSERT_EQ(read(builtPath), read(savedPath));
+
+    SnapshotBuilder<> unweighted{SnapshotBuildOptions{.memoryBudget = 8 * 1000}};
+    unweighted.build(edgesPath, builtPath);
+
+    auto mapped = BreadthFirstSearch<std::string, MappedCsrGraph>::load(builtPath);
+    BreadthFirstSearch<std::string> built{pairs};
+
+    for (int query = 0; query < 30; query++) {
+        auto source = "v" + std::to_string(random() % 1500);
+        auto target = "v" + std::to_string(random() % 1500);
+
+        ASSERT_EQ(mapped.getShortestPathBetween(source, target), built.getShortestPathBetween(source, target));
+    }
+
+    for (const auto& path : {edgesPath, builtPath, savedPath}) {
+        std::filesystem::remove(path);
+    }
+}
+
+
+TEST(PathFinderTests, SnapshotBuildersSpillToPrivateDirectories) {
+    auto spillDirectory = std::filesystem::temp_directory_path() / "snapshot_spill_test";
+    auto edgesPath = (std::filesystem::temp_directory_path() / "spill_edges.txt").string();
+    auto firstPath = (std::filesystem::temp_directory_path() / "spill_first.bin").string();
+    auto secondPath = (std::filesystem::temp_directory_path() / "spill_second.bin").string();
+
+    std::filesystem::remove_all(spillDirectory);
+    std::filesystem::create_directory(spillDirectory);
+    {
+        std::ofstream output{edgesPath};
+        for (int i = 0; i < 2000; i++) {
+            output << i % 300 << ' ' << (i * 7) % 300 << '\n';
+        }
+    }
+
+    auto entries = [&] {
+        auto iterator = std::filesystem::directory_iterator(spillDirectory);
+        return std::distance(std::filesystem::begin(iterator), std::filesystem::end(iterator));
+    };
+
+    {
+        SnapshotBuildOptions options{.memoryBudget = 4000, .spillDirectory = spillDirectory};
+        SnapshotBuilder<> first{options};
+        SnapshotBuilder<> second{options};
+
+        first.build(edgesPath, firstPath);
+        second.build(edgesPath, secondPath);
+        ASSERT_GT(first.runCount(), 1u);
+        ASSERT_EQ(entries(), 2);
+
+        first.build(edgesPath, firstPath);
+        ASSERT_EQ(entries(), 2);
+    }
+    ASSERT_EQ(entries(), 0);
+
+    std::filesystem::remove_all(spillDirectory);
+    for (const auto& path : {edgesPath, firstPath, secondPath}) {
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,76 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "pipeline.h"
+
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <string>
+
+
+TEST(PipelineTests, FusesMapFilterReduce) {
+    using namespace pipeline;
+    std::vector<int> v{1, 2, 3, 4, 5};
+
+    auto sumOfOddIncrements = pipe(v)
+        | map([](int x) { return x + 1; })
+        | filter([](int x) { return x % 2 != 0; })
+        | reduce(std::plus<>{}, 0);
+
+    ASSERT_EQ(sumOfOddIncrements, 3 + 5);
+}
+
+
+TEST(PipelineTests, StagesRunOncePerElement) {
+    using namespace pipeline;
+    std::list<std::string> words{"Hello", "World", "how", "are", "you", "?"};
+    int lengthsComputed = 0;
+
+    auto shortest = pipe(words)
+        | map([&lengthsComputed](const std::string& word) {
+            lengthsComputed++;
+            return static_cast<int>(word.length());
+        })
+        | filter([](int length) { return length > 1; })
+        | reduce([](int lowest, int length) { return std::min(lowest, length); }, 100);
+
+    ASSERT_EQ(shortest, 3);
+    ASSERT_EQ(lengthsComputed, 6);
+}
+
+
+TEST(PipelineTests, IsARange) {
+    using namespace pipeline;
+    std::vector<int> v{1, 2, 3, 4, 5};
+
+    auto odd = pipe(v) | filter([](int x) { return x % 2 != 0; }) | map([](int x) { return x * 10; });
+    static_assert(std::ranges::input_range<decltype(odd)>);
+
+    ASSERT_THAT(std::vector<int>(odd.begin(), odd.end()), ::testing::ElementsAre(10, 30, 50));
+    ASSERT_EQ(std::ranges::distance(odd), 3);
+    ASSERT_EQ(*std::ranges::max_element(odd), 50);
+
+    auto fromView = pipe(std::views::iota(0, 10)) | filter([](int x) { return x % 3 == 0; }) | reduce(std::plus<>{}, 0);
+    ASSERT_EQ(fromView, 0 + 3 + 6 + 9);
+}
+
+
+TEST(PipelineTests, ParallelReduceMatchesSerial) {
+    using namespace pipeline;
+    ThreadPool pool{4};
+
+    std::vector<std::int64_t> values(200'003);
+    std::iota(values.begin(), values.end(), -1000);
+
+    auto square = map([](std::int64_t x) { return x * x % 1009; });
+    auto even = filter([](std::int64_t x) { return x % 2 == 0; });
+
+    auto serial = pipe(values) | square | even | reduce(std::plus<>{}, std::int64_t{7});
+    auto parallel = pipe(values) | square | even | parallelReduce(std::plus<>{}, std::int64_t{7}, pool);
+
+    ASSERT_EQ(parallel, serial);
+
+    std::vector<std::int64_t> empty{};
+    ASSERT_EQ(pipe(empty) | square | parallelReduce(std::plus<>{}, std::int64_t{7}, pool), 7);
+}
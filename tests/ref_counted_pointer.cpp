@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "ref_counted_pointer.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+// Counts live instances, so tests can check that every pointee is freed.
+struct TrackedVersion {
+    static inline std::atomic<int> live{0};
+
+    int version;
+    int copy;
+
+    explicit TrackedVersion(int version) : version(version), copy(version) {
+        live++;
+    }
+
+    ~TrackedVersion() {
+        live--;
+    }
+};
+
+
+TEST(RefCountedPointerTests, CopiesShareOneCount) {
+    {
+        auto first = makeRefCounted<TrackedVersion>(7);
+        ASSERT_EQ(first.useCount(), 1u);
+
+        auto second = first;
+        RefCountedPointer<TrackedVersion> third{};
+        third = second;
+
+        ASSERT_EQ(first.useCount(), 3u);
+        ASSERT_EQ(third->version, 7);
+        ASSERT_TRUE(first == third);
+        ASSERT_EQ(TrackedVersion::live, 1);
+
+        second = nullptr;
+        ASSERT_EQ(first.useCount(), 2u);
+    }
+
+    ASSERT_EQ(TrackedVersion::live, 0);
+}
+
+
+TEST(RefCountedPointerTests, MoveLeavesSourceNull) {
+    auto first = makeRefCounted<TrackedVersion>(1);
+    auto second = std::move(first);
+
+    ASSERT_TRUE(first.isNull());
+    ASSERT_EQ(second.useCount(), 1u);
+
+    second = makeRefCounted<TrackedVersion>(2);
+    ASSERT_EQ((*second).version, 2);
+    ASSERT_EQ(TrackedVersion::live, 1);
+}
+
+
+TEST(RefCountedPointerTests, SlotHandsOutAndReplacesPointers) {
+    {
+        AtomicRefCountedPointer<const TrackedVersion> slot{makeRefCounted<const TrackedVersion>(1)};
+
+        auto loaded = slot.load();
+        ASSERT_EQ(loaded->version, 1);
+        ASSERT_EQ(loaded.useCount(), 2u);
+
+        auto previous = slot.exchange(makeRefCounted<const TrackedVersion>(2));
+        ASSERT_TRUE(previous == loaded);
+        ASSERT_EQ(slot.load()->version, 2);
+
+        previous = nullptr;
+        loaded = nullptr;
+        ASSERT_EQ(TrackedVersion::live, 1);
+
+        slot.store(nullptr);
+        ASSERT_TRUE(slot.load().isNull());
+        ASSERT_EQ(TrackedVersion::live, 0);
+
+        slot.store(makeRefCounted<const TrackedVersion>(3));
+    }
+
+    ASSERT_EQ(TrackedVersion::live, 0);
+}
+
+
+TEST(RefCountedPointerTests, ReadersNeverSeeFreedVersions) {
+    {
+        AtomicRefCountedPointer<const TrackedVersion> slot{makeRefCounted<const TrackedVersion>(0)};
+        std::atomic<bool> publishing{true};
+        std::atomic<int> torn{0};
+
+        std::vector<std::thread> readers{};
+        for (int i = 0; i < 4; i++) {
+            readers.emplace_back([&] {
+                int lastSeen = 0;
+
+                while (publishing.load(std::memory_order_relaxed)) {
+                    auto current = slot.load();
+                    auto again = current;
+
+                    if (current->version != current->copy || current->version < lastSeen) {
+                        torn++;
+                    }
+                    lastSeen = again->version;
+                }
+            });
+        }
+
+        for (int version = 1; version <= 20000; version++) {
+            slot.store(makeRefCounted<const TrackedVersion>(version));
+        }
+
+        publishing = false;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        ASSERT_EQ(torn, 0);
+        ASSERT_EQ(slot.load()->version, 20000);
+        ASSERT_EQ(TrackedVersion::live, 1);
+    }
+
+    ASSERT_EQ(TrackedVersion::live, 0);
+}
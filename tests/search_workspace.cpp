@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "search_workspace.h"
+
+
+TEST(SearchWorkspaceTests, ResetForgetsReachedVertices) {
+    SearchWorkspace<int> workspace{};
+
+    workspace.reset(4);
+    workspace.reach(1, 10);
+    workspace.reach(3, 30);
+
+    ASSERT_TRUE(workspace.reached(1));
+    ASSERT_FALSE(workspace.reached(2));
+    ASSERT_EQ(workspace.distances[3], 30);
+
+    workspace.reset(4);
+
+    ASSERT_FALSE(workspace.reached(1));
+    ASSERT_FALSE(workspace.reached(3));
+}
+
+
+TEST(SearchWorkspaceTests, GrowsForLargerGraphs) {
+    SearchWorkspace<int> workspace{};
+
+    workspace.reset(2);
+    workspace.reach(1, 1);
+    workspace.frontier.push(1, 1);
+
+    workspace.reset(100);
+
+    ASSERT_FALSE(workspace.reached(1));
+    ASSERT_FALSE(workspace.reached(99));
+    ASSERT_TRUE(workspace.frontier.empty());
+    ASSERT_THAT(workspace.vertexQueue, ::testing::SizeIs(100));
+
+    workspace.frontier.push(99, 5);
+    ASSERT_EQ(workspace.frontier.top(), 99u);
+}
+
+
+TEST(SearchWorkspaceTests, LevelWorkspaceResetForgetsReachedVertices) {
+    LevelWorkspace workspace{};
+
+    workspace.reset(4);
+    workspace.reach(2, 1);
+    workspace.parents[2] = 0;
+
+    ASSERT_TRUE(workspace.reached(2));
+    ASSERT_EQ(workspace.levels[2], 1u);
+
+    workspace.reset(50);
+
+    ASSERT_FALSE(workspace.reached(2));
+    ASSERT_FALSE(workspace.reached(49));
+    ASSERT_THAT(workspace.vertexQueue, ::testing::SizeIs(50));
+}
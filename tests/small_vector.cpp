@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "small_vector.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <string>
+
+
+TEST(SmallVectorTests, StaticVectorPacksElements) {
+    StaticVector<std::string, 4> words{"hello", "bye"};
+    words.push_back("goodbye");
+
+    ASSERT_THAT(words, ::testing::ElementsAre("hello", "bye", "goodbye"));
+    ASSERT_EQ(words.capacity(), 4u);
+    ASSERT_EQ(&words[1], words.data() + 1);
+
+    words.push_back("salut");
+    ASSERT_THROW(words.push_back("hola"), std::length_error);
+    ASSERT_EQ(words.size(), 4u);
+
+    words.pop_back();
+    ASSERT_EQ(words.back(), "goodbye");
+}
+
+
+TEST(SmallVectorTests, IteratorsWorkWithAlgorithms) {
+    StaticVector<int, 10> numbers{};
+    std::vector<int> source{5, 2, 4, 1, 3};
+
+    std::copy(source.begin(), source.end(), std::back_inserter(numbers));
+    std::sort(numbers.begin(), numbers.end());
+
+    ASSERT_THAT(numbers, ::testing::ElementsAre(1, 2, 3, 4, 5));
+    ASSERT_EQ(numbers.end() - numbers.begin(), 5);
+    ASSERT_EQ(std::accumulate(numbers.rbegin(), numbers.rend(), 0), 15);
+}
+
+
+TEST(SmallVectorTests, SmallVectorSpillsToTheHeap) {
+    SmallVector<std::string, 2> words{"a", "b"};
+    ASSERT_TRUE(words.isInline());
+
+    words.push_back(words[0]);
+    words.emplace_back(3, 'c');
+
+    ASSERT_FALSE(words.isInline());
+    ASSERT_GE(words.capacity(), 4u);
+    ASSERT_THAT(words, ::testing::ElementsAre("a", "b", "a", "ccc"));
+
+    words.resize(1);
+    ASSERT_THAT(words, ::testing::ElementsAre("a"));
+}
+
+
+TEST(SmallVectorTests, CopiesAndMovesKeepElements) {
+    SmallVector<std::unique_ptr<int>, 2> inlineOwners{};
+    inlineOwners.push_back(std::make_unique<int>(1));
+
+    auto movedInline = std::move(inlineOwners);
+    ASSERT_TRUE(inlineOwners.empty());
+    ASSERT_EQ(*movedInline[0], 1);
+
+    SmallVector<std::unique_ptr<int>, 2> heapOwners{};
+    for (int i = 0; i < 5; i++) {
+        heapOwners.push_back(std::make_unique<int>(i));
+    }
+    auto heapBuffer = heapOwners.data();
+
+    SmallVector<std::unique_ptr<int>, 2> movedHeap{};
+    movedHeap = std::move(heapOwners);
+    ASSERT_EQ(movedHeap.data(), heapBuffer);
+    ASSERT_TRUE(heapOwners.empty());
+    ASSERT_TRUE(heapOwners.isInline());
+
+    SmallVector<int, 2> numbers{1, 2, 3};
+    auto copy = numbers;
+    copy[0] = 9;
+
+    ASSERT_THAT(numbers, ::testing::ElementsAre(1, 2, 3));
+    ASSERT_FALSE(copy == numbers);
+    copy[0] = 1;
+    ASSERT_TRUE(copy == numbers);
+}
@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "smart_pointers.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+
+TEST(InlineUniquePointerTests, SmallValuesLiveInTheHandle) {
+    static_assert(InlineUniquePointer<std::string>::STORES_INLINE);
+    static_assert(!InlineUniquePointer<std::array<char, 64>>::STORES_INLINE);
+
+    auto text = makeInlineUnique<std::string>("hello");
+    auto address = reinterpret_cast<const std::byte*>(text.get());
+    auto handle = reinterpret_cast<const std::byte*>(&text);
+
+    ASSERT_EQ(*text, "hello");
+    ASSERT_EQ(text->size(), 5u);
+    ASSERT_TRUE(address >= handle && address < handle + sizeof(text));
+
+    // Dereferencing skips the engaged check but reaches the same object.
+    ASSERT_EQ(&*text, text.get());
+    ASSERT_EQ(text.operator->(), text.get());
+}
+
+
+TEST(InlineUniquePointerTests, MovesLeaveTheSourceNull) {
+    auto u1 = makeInlineUnique<std::string>("a string too long for the small string buffer");
+    auto u2 = std::move(u1);
+
+    ASSERT_TRUE(u1.isNull());
+    ASSERT_FALSE(u2.isNull());
+    ASSERT_EQ(*u2, "a string too long for the small string buffer");
+
+    InlineUniquePointer<std::string> u3{};
+    ASSERT_TRUE(u3.isNull());
+
+    u3 = std::move(u2);
+    ASSERT_TRUE(u2.isNull());
+    ASSERT_EQ(u3->size(), 45u);
+
+    u3 = nullptr;
+    ASSERT_TRUE(u3.isNull());
+}
+
+
+TEST(InlineUniquePointerTests, LargeValuesSpillToTheHeap) {
+    using Large = std::array<int, 64>;
+
+    auto u1 = makeInlineUnique<Large>();
+    (*u1)[63] = 7;
+
+    auto address = reinterpret_cast<const std::byte*>(u1.get());
+    auto handle = reinterpret_cast<const std::byte*>(&u1);
+    ASSERT_TRUE(address < handle || address >= handle + sizeof(u1));
+
+    std::vector<InlineUniquePointer<Large>> handles{};
+    handles.push_back(std::move(u1));
+    handles.push_back(makeInlineUnique<Large>());
+
+    ASSERT_TRUE(u1.isNull());
+    ASSERT_EQ(handles[0].get(), reinterpret_cast<const Large*>(address));
+    ASSERT_EQ((*handles[0])[63], 7);
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "string_column.h"
+
+#include <random>
+
+
+std::vector<std::string> randomWords(std::size_t count) {
+    std::mt19937 random{17};
+    std::vector<std::string> words(count);
+
+    for (auto& word : words) {
+        // Mostly short words over a small alphabet, so equal strings are
+        // common, with a few longer than a vector.
+        auto length = random() % 10 == 0 ? random() % 60 : random() % 6;
+        for (std::size_t i = 0; i < length; i++) {
+            word.push_back(static_cast<char>('a' + random() % 3));
+        }
+    }
+
+    return words;
+}
+
+
+TEST(StringColumnTests, HoldsTheConvertedStrings) {
+    std::vector<std::string> v{ "Hello", "World", "how", "are", "you", "?", "" };
+    StringColumn column{v};
+
+    ASSERT_EQ(column.size(), v.size());
+    for (std::size_t i = 0; i < v.size(); i++) {
+        ASSERT_EQ(column[i], v[i]);
+    }
+
+    column.push_back("again");
+    ASSERT_EQ(column.size(), 8);
+    ASSERT_EQ(column[7], "again");
+    ASSERT_EQ(column[0], "Hello");
+
+    ASSERT_TRUE(StringColumn{}.empty());
+}
+
+
+TEST(StringColumnTests, ReducesLengthsLikeTestReduceWithString) {
+    StringColumn column{std::vector<std::string>{ "Hello", "World", "how", "are", "you", "?" }};
+
+    for (auto level : supportedSimdLevels()) {
+        ASSERT_EQ(lengthBounds(column, level), (LengthBounds{1, 5}));
+        ASSERT_THAT(stringLengths(column, level), ::testing::ElementsAre(5, 5, 3, 3, 3, 1));
+    }
+
+    ASSERT_EQ(lengthBounds(StringColumn{}), (LengthBounds{std::numeric_limits<std::uint32_t>::max(), 0}));
+}
+
+
+TEST(StringColumnTests, KernelsMatchScalar) {
+    for (std::size_t size : {0, 5, 17, 64, 1000}) {
+        auto words = randomWords(size);
+        StringColumn column{words};
+
+        std::vector<std::uint32_t> expectedLengths{};
+        for (const auto& word : words) {
+            expectedLengths.push_back(static_cast<std::uint32_t>(word.size()));
+        }
+
+        for (auto level : supportedSimdLevels()) {
+            ASSERT_EQ(stringLengths(column, level), expectedLengths);
+
+            if (size > 0) {
+                auto [shortest, longest] = std::minmax_element(expectedLengths.begin(), expectedLengths.end());
+                ASSERT_EQ(lengthBounds(column, level), (LengthBounds{*shortest, *longest}));
+            }
+
+            std::vector<std::uint64_t> mask{};
+            selectLengths(column, 2, 4, mask, level);
+            ASSERT_THAT(mask, ::testing::SizeIs((size + 63) / 64));
+            for (std::size_t i = 0; i < size; i++) {
+                ASSERT_EQ(isSelected(mask, i), 2 <= words[i].size() && words[i].size() <= 4) << "index " << i;
+            }
+
+            selectLengths(column, 4, 2, mask, level);
+            ASSERT_EQ(std::count(mask.begin(), mask.end(), 0u), static_cast<std::ptrdiff_t>(mask.size()));
+
+            for (const auto& needle : {std::string{}, std::string{"ab"}, std::string{"abcab"}, words.empty() ? std::string{} : words.back()}) {
+                selectEqual(column, needle, mask, level);
+                for (std::size_t i = 0; i < size; i++) {
+                    ASSERT_EQ(isSelected(mask, i), words[i] == needle) << "index " << i << " needle " << needle;
+                }
+            }
+        }
+    }
+}
+
+
+TEST(StringColumnTests, ComparesNeedlesLongerThanAVector) {
+    std::string longWord(40, 'x');
+    std::string nearlyLongWord = longWord;
+    nearlyLongWord[35] = 'y';
+
+    StringColumn column{std::vector<std::string>{longWord, nearlyLongWord, "x", longWord}};
+
+    for (auto level : supportedSimdLevels()) {
+        std::vector<std::uint64_t> mask{};
+        selectEqual(column, longWord, mask, level);
+        ASSERT_THAT(mask, ::testing::ElementsAre(0b1001u));
+    }
+}
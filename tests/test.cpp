@@ -14,19 +14,32 @@
 #include "basic_memory.cpp"
 #include "collections.cpp"
 #include "user_types.cpp"
+#include "csr_graph.cpp"
+#include "dynamic_graph.cpp"
+#include "vertex_interner.cpp"
+#include "graph_snapshot.cpp"
+#include "edge_list.cpp"
+#include "indexed_heap.cpp"
+#include "weight_filters.cpp"
+#include "number_parsing.cpp"
+#include "thread_pool.cpp"
+#include "arena.cpp"
+#include "smart_pointers.cpp"
+#include "small_vector.cpp"
+#include "parallel_collections.cpp"
+#include "pipeline.cpp"
+#include "string_column.cpp"
+#include "ref_counted_pointer.cpp"
+#include "search_workspace.cpp"
 #include "pathfinder.cpp"
 #include "move_semantics.cpp"
 #include "classes.cpp"
 
 
 std::vector<int> readNumbers(std::istream& input) {
-  std::string line;
+  std::vector<int> vector{};
+  readNumbers(input, vector);
 
-  std::getline(input, line);
-  std::istringstream line_stream(line);
-  std::istream_iterator<int> begin(line_stream), end;
-  
-  auto vector = std::vector<int>(begin, end); 
   std::cout << "Address: " << &vector << std::endl;
   return vector;
 }
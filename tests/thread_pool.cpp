@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "thread_pool.h"
+
+#include <numeric>
+#include <stdexcept>
+
+
+TEST(ThreadPoolTests, RunsEveryTaskOnce) {
+    ThreadPool pool{4};
+    std::vector<int> counts(1000, 0);
+
+    for (int round = 0; round < 20; round++) {
+        pool.run(counts.size(), [&counts](std::size_t task) {
+            counts[task]++;
+        });
+    }
+
+    ASSERT_EQ(pool.threadCount(), 4u);
+    ASSERT_THAT(counts, ::testing::Each(20));
+}
+
+
+TEST(ThreadPoolTests, SingleThreadRunsInline) {
+    ThreadPool pool{1};
+    std::vector<std::size_t> order{};
+
+    pool.run(3, [&order](std::size_t task) {
+        order.push_back(task);
+    });
+
+    ASSERT_THAT(order, ::testing::ElementsAre(0, 1, 2));
+}
+
+
+TEST(ThreadPoolTests, ConcurrentCallersTakeTurns) {
+    ThreadPool pool{4};
+    std::vector<std::vector<int>> counts(3, std::vector<int>(500, 0));
+    std::vector<std::thread> callers{};
+
+    for (std::size_t caller = 0; caller < counts.size(); caller++) {
+        callers.emplace_back([&pool, &counts, caller] {
+            for (int round = 0; round < 20; round++) {
+                pool.run(counts[caller].size(), [&counts, caller](std::size_t task) {
+                    counts[caller][task]++;
+                });
+            }
+        });
+    }
+
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    for (const auto& callerCounts : counts) {
+        ASSERT_THAT(callerCounts, ::testing::Each(20));
+    }
+}
+
+
+TEST(ThreadPoolTests, NestedRunExecutesInline) {
+    ThreadPool pool{4};
+    std::vector<std::atomic<int>> counts(8 * 8);
+
+    pool.run(8, [&pool, &counts](std::size_t outer) {
+        pool.run(8, [&counts, outer](std::size_t inner) {
+            counts[outer * 8 + inner]++;
+        });
+    });
+
+    for (const auto& count : counts) {
+        ASSERT_EQ(count.load(), 1);
+    }
+}
+
+
+TEST(ThreadPoolTests, ThrowingTaskIsRethrownOnTheCaller) {
+    ThreadPool pool{4};
+
+    // Every task throws, so the caller and the workers all hit one.
+    ASSERT_THROW(pool.run(64, [](std::size_t) {
+        throw std::runtime_error("task failed");
+    }), std::runtime_error);
+
+    ASSERT_THROW(pool.run(1000, [](std::size_t task) {
+        if (task == 10) {
+            throw std::out_of_range("task 10");
+        }
+    }), std::out_of_range);
+
+    // The pool is still usable afterwards.
+    std::vector<int> counts(100, 0);
+    pool.run(counts.size(), [&counts](std::size_t task) {
+        counts[task]++;
+    });
+    ASSERT_THAT(counts, ::testing::Each(1));
+}
@@ -0,0 +1,46 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "vertex_interner.h"
+
+
+TEST(VertexInternerTests, AssignsDenseIds) {
+    VertexInterner<std::string> interner{};
+
+    ASSERT_EQ(interner.intern("hello"), 0u);
+    ASSERT_EQ(interner.intern("goodbye"), 1u);
+    ASSERT_EQ(interner.intern("hello"), 0u);
+    ASSERT_EQ(interner.size(), 2u);
+
+    ASSERT_EQ(interner.labelOf(1), "goodbye");
+    ASSERT_EQ(interner.find("goodbye"), 1u);
+    ASSERT_EQ(interner.find("meowww"), std::nullopt);
+}
+
+
+TEST(VertexInternerTests, SurvivesGrowth) {
+    VertexInterner<std::string> interner{};
+
+    for (int i = 0; i < 10000; i++) {
+        ASSERT_EQ(interner.intern(std::to_string(i)), static_cast<unsigned>(i));
+    }
+
+    for (int i = 0; i < 10000; i++) {
+        ASSERT_EQ(interner.find(std::to_string(i)), static_cast<unsigned>(i));
+        ASSERT_EQ(interner.labelOf(i), std::to_string(i));
+    }
+
+    ASSERT_EQ(interner.intern(""), 10000u);
+    ASSERT_EQ(interner.labelOf(10000), "");
+}
+
+
+TEST(VertexInternerTests, GenericVertexType) {
+    VertexInterner<int> interner{};
+
+    ASSERT_EQ(interner.intern(42), 0u);
+    ASSERT_EQ(interner.intern(7), 1u);
+    ASSERT_EQ(interner.intern(42), 0u);
+    ASSERT_EQ(interner.labelOf(1), 7);
+    ASSERT_EQ(interner.find(8), std::nullopt);
+}
@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "weight_filters.h"
+
+#include <random>
+
+
+std::vector<SimdLevel> supportedSimdLevels() {
+    std::vector<SimdLevel> levels{SimdLevel::Scalar};
+
+    if (detectedSimdLevel() != SimdLevel::Scalar) {
+        levels.push_back(SimdLevel::Sse41);
+    }
+    if (detectedSimdLevel() == SimdLevel::Avx2) {
+        levels.push_back(SimdLevel::Avx2);
+    }
+
+    return levels;
+}
+
+
+template <typename E, typename Filter>
+void expectSelectionMatchesFilter(const std::vector<E>& weights, const Filter& filter) {
+    for (auto level : supportedSimdLevels()) {
+        std::vector<std::uint64_t> mask{};
+        selectWeights(std::span<const E>(weights), filter, mask, level);
+
+        ASSERT_THAT(mask, ::testing::SizeIs((weights.size() + 63) / 64));
+
+        for (std::size_t i = 0; i < weights.size(); i++) {
+            ASSERT_EQ(isSelected(mask, i), filter(weights[i])) << "index " << i;
+        }
+    }
+}
+
+
+TEST(WeightFiltersTests, IntKernelsMatchScalar) {
+    std::mt19937 random{3};
+    std::vector<int> weights(1000);
+
+    for (auto& weight : weights) {
+        weight = static_cast<int>(random() % 61) - 30;
+    }
+
+    expectSelectionMatchesFilter(weights, WeightAbove<int>{15});
+    expectSelectionMatchesFilter(weights, WeightBelow<int>{-3});
+    expectSelectionMatchesFilter(weights, WeightBetween<int>{-5, 5});
+}
+
+
+TEST(WeightFiltersTests, FloatKernelsMatchScalar) {
+    std::mt19937 random{5};
+    std::vector<float> weights(515);
+
+    for (auto& weight : weights) {
+        weight = static_cast<float>(random() % 1000) / 10.0f;
+    }
+
+    expectSelectionMatchesFilter(weights, WeightAbove<float>{15.5f});
+    expectSelectionMatchesFilter(weights, WeightBelow<float>{50.0f});
+    expectSelectionMatchesFilter(weights, WeightBetween<float>{10.0f, 20.0f});
+}
+
+
+TEST(WeightFiltersTests, OtherTypesUseScalarPath) {
+    std::vector<double> weights{1.0, 20.0, 16.0, 3.0};
+
+    expectSelectionMatchesFilter(weights, WeightAbove<double>{15.0});
+}